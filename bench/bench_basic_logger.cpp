@@ -0,0 +1,137 @@
+// 编译期策略日志器基准：相同输出布局下对比运行时配置的 FileLogger 与 BasicLogger
+// 场景：HumanFriendly/Json × sync/async × 1..N 线程，均写文件（EveryNBytes 64KiB），不输出控制台
+// 输出 CSV：impl,format,mode,threads,records,seconds,records_per_s,ns_per_call
+//   seconds 为从开始到日志器析构（队列写空、文件关闭）；ns_per_call 为生产者调用的平均耗时
+//
+// 用法：xzero_bench_policy [--threads N] [--records N] [--dir 目录]
+#include "BasicLogger.h"
+#include "XZeroLog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+typedef BasicLogger<XZeroPolicy::Human, XZeroPolicy::FileOutput, XZeroPolicy::Async,
+                    XZeroPolicy::Time, XZeroPolicy::Platform, XZeroPolicy::Level,
+                    XZeroPolicy::Thread, XZeroPolicy::Source, XZeroPolicy::Message,
+                    XZeroPolicy::KeyValues, XZeroPolicy::Mdc, XZeroPolicy::ErrorCode>
+    AsyncHumanFileLogger;
+typedef BasicLogger<XZeroPolicy::Json, XZeroPolicy::FileOutput, XZeroPolicy::Async,
+                    XZeroPolicy::Time, XZeroPolicy::Platform, XZeroPolicy::Level,
+                    XZeroPolicy::Thread, XZeroPolicy::Source, XZeroPolicy::Message,
+                    XZeroPolicy::KeyValues, XZeroPolicy::Mdc, XZeroPolicy::ErrorCode>
+    AsyncJsonFileLogger;
+
+struct Options {
+    std::size_t max_threads{0};
+    std::size_t records{200000};
+    std::string dir{"build/bench"};
+};
+
+LoggerConfig make_config(const Options& opt, const std::string& name, bool json, bool async) {
+    LoggerConfig cfg;
+    cfg.toFile = true;
+    cfg.toConsole = false;
+    cfg.filePath = opt.dir + "/" + name + ".log";
+    cfg.writeMode = FileWriteMode::Overwrite;
+    cfg.logFormat = json ? LogFormat::Json : LogFormat::HumanFriendly;
+    cfg.asyncLogging = async;
+    cfg.flushPolicy = FlushPolicy::EveryNBytes;
+    return cfg;
+}
+
+std::unique_ptr<Logger> make_logger(bool policy, bool json, bool async, const LoggerConfig& cfg) {
+    if (!policy) return XZeroLog().InitLogger(cfg);
+    if (async) {
+        if (json) return BasicLoggerFactory<AsyncJsonFileLogger>().InitLogger(cfg);
+        return BasicLoggerFactory<AsyncHumanFileLogger>().InitLogger(cfg);
+    }
+    if (json) return BasicLoggerFactory<JsonFileLogger>().InitLogger(cfg);
+    return BasicLoggerFactory<HumanFileLogger>().InitLogger(cfg);
+}
+
+void run_case(const Options& opt, bool policy, bool json, bool async, std::size_t threads) {
+    const char* impl = policy ? "basic" : "file";
+    const char* format = json ? "json" : "human";
+    const char* mode = async ? "async" : "sync";
+    const std::string name = std::string("policy-") + impl + "-" + format + "-" + mode + "-t" +
+                             std::to_string(threads);
+    const LoggerConfig cfg = make_config(opt, name, json, async);
+    const std::size_t per_thread = opt.records;
+
+    std::atomic<std::int64_t> call_ns{0};
+    const auto begin = Clock::now();
+    {
+        std::unique_ptr<Logger> logger = make_logger(policy, json, async, cfg);
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                const auto t0 = Clock::now();
+                for (std::size_t i = 0; i < per_thread; ++i) {
+                    XZERO_INFOF(logger, "bench thread={} seq={} payload=request completed status=200", t, i);
+                }
+                call_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+            });
+        }
+        go.store(true, std::memory_order_release);
+        for (auto& w : workers) w.join();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    const double records = static_cast<double>(threads * per_thread);
+    std::printf("%s,%s,%s,%zu,%.0f,%.4f,%.0f,%.1f\n", impl, format, mode, threads, records, seconds,
+                records / seconds, static_cast<double>(call_ns.load()) / records);
+    std::fflush(stdout);
+}
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            opt.max_threads = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--records" && i + 1 < argc) {
+            opt.records = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--dir" && i + 1 < argc) {
+            opt.dir = argv[++i];
+        } else {
+            std::fprintf(stderr, "用法: %s [--threads N] [--records N] [--dir 目录]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) return 1;
+    if (opt.max_threads == 0) {
+        const unsigned hw = std::thread::hardware_concurrency();
+        opt.max_threads = std::min<std::size_t>(hw > 0 ? hw : 1, 8);
+    }
+
+    std::printf("impl,format,mode,threads,records,seconds,records_per_s,ns_per_call\n");
+    for (int json = 0; json < 2; ++json) {
+        for (int async = 0; async < 2; ++async) {
+            for (std::size_t threads = 1; threads <= opt.max_threads; threads *= 2) {
+                // 同一场景两种实现相邻运行，便于对比
+                run_case(opt, false, json != 0, async != 0, threads);
+                run_case(opt, true, json != 0, async != 0, threads);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+// JSON 转义微基准：对比旧版逐字节 ostringstream 实现与标量/SSE2/AVX2 实现
+// 输出 CSV：impl,payload,bytes,iterations,ns_per_op,mb_per_s
+#include "JsonEscape.h"
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 旧版实现（FileLogger::log 中的 escape_json lambda），作为基线
+std::string legacy_escape(const std::string& in) {
+    std::ostringstream e;
+    for (char c : in) {
+        switch (c) {
+        case '\"': e << "\\\""; break;
+        case '\\': e << "\\\\"; break;
+        case '\n': e << "\\n"; break;
+        case '\r': e << "\\r"; break;
+        case '\t': e << "\\t"; break;
+        default: e << c; break;
+        }
+    }
+    return e.str();
+}
+
+struct Payload {
+    const char* name;
+    std::string data;
+};
+
+std::vector<Payload> make_payloads() {
+    std::vector<Payload> out;
+    std::string ascii;
+    while (ascii.size() < 4096) ascii += "request completed user=alice path=/api/v1/orders status=200 ";
+    out.push_back(Payload{"ascii_4k", ascii});
+
+    std::string utf8;
+    while (utf8.size() < 4096) utf8 += u8"用户请求处理完成，订单号 123456，耗时 42ms；";
+    out.push_back(Payload{"utf8_4k", utf8});
+
+    std::string quoted;
+    while (quoted.size() < 4096) quoted += "{\"key\":\"value\",\"path\":\"C:\\\\tmp\"}\n";
+    out.push_back(Payload{"escape_heavy_4k", quoted});
+
+    out.push_back(Payload{"short_64", ascii.substr(0, 64)});
+    return out;
+}
+
+template <typename Fn>
+void run(const char* impl, const Payload& p, Fn fn) {
+    const std::size_t iterations = p.data.size() >= 1024 ? 20000 : 500000;
+    std::string out;
+    std::size_t sink = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        out.clear();
+        fn(out, p.data);
+        sink += out.size();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+    const double ns_per_op = ns / static_cast<double>(iterations);
+    const double mb_per_s = static_cast<double>(p.data.size()) * iterations / (ns / 1e9) / (1024.0 * 1024.0);
+    std::printf("%s,%s,%zu,%zu,%.1f,%.1f\n", impl, p.name, p.data.size(), iterations, ns_per_op,
+                mb_per_s);
+    if (sink == 0) std::printf("# unexpected empty output\n");
+}
+
+} // namespace
+
+int main() {
+    const std::vector<Payload> payloads = make_payloads();
+
+    // 正确性自检：各实现输出一致
+    for (const auto& p : payloads) {
+        std::string a, b, c;
+        XZeroJson::escape_append_scalar(a, p.data.data(), p.data.size());
+        if (XZeroJson::escape_append_sse2(b, p.data.data(), p.data.size()) && a != b) {
+            std::fprintf(stderr, "sse2 mismatch on %s\n", p.name);
+            return 1;
+        }
+        if (XZeroJson::escape_append_avx2(c, p.data.data(), p.data.size()) && a != c) {
+            std::fprintf(stderr, "avx2 mismatch on %s\n", p.name);
+            return 1;
+        }
+    }
+
+    std::printf("# dispatch=%s\n", XZeroJson::escape_impl_name());
+    std::printf("impl,payload,bytes,iterations,ns_per_op,mb_per_s\n");
+    for (const auto& p : payloads) {
+        run("legacy_ostringstream", p, [](std::string& out, const std::string& in) {
+            out = legacy_escape(in);
+        });
+        run("scalar", p, [](std::string& out, const std::string& in) {
+            XZeroJson::escape_append_scalar(out, in.data(), in.size());
+        });
+        std::string probe;
+        if (XZeroJson::escape_append_sse2(probe, "", 0)) {
+            run("sse2", p, [](std::string& out, const std::string& in) {
+                XZeroJson::escape_append_sse2(out, in.data(), in.size());
+            });
+        }
+        if (XZeroJson::escape_append_avx2(probe, "", 0)) {
+            run("avx2", p, [](std::string& out, const std::string& in) {
+                XZeroJson::escape_append_avx2(out, in.data(), in.size());
+            });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,348 @@
+// 日志器综合基准：生产者单次调用延迟分位数、1..N 线程吞吐、入队到写入文件的端到端延迟
+// 场景矩阵：sync/async × HumanFriendly/Json × MDC 开/关 × 滚动 开/关 × 控制台 开/关
+// 输出 CSV（默认）或 JSON，便于版本间对比回归；建议 -DCMAKE_BUILD_TYPE=Release 构建
+//
+// 用法：xzero_bench [--threads N] [--records N] [--json] [--quick] [--filter 子串] [--dir 目录]
+//   --threads  最大线程数，按 1,2,4..N 递增（默认 min(硬件线程数, 8)）
+//   --records  每线程记录条数（默认 100000，--quick 时 20000 且只测 1 与 N 线程）
+//   --filter   只运行名称包含该子串的场景，如 async-json
+//   --dir      日志输出目录（默认 build/bench）
+// 控制台场景的输出被重定向到 /dev/null，结果仍写到原标准输出。
+#include "FileSink.h"
+#include "LogContext.h"
+#include "LogSink.h"
+#include "XZeroLog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+    std::size_t max_threads{0};
+    std::size_t records{100000};
+    bool json{false};
+    bool quick{false};
+    std::string filter;
+    std::string dir{"build/bench"};
+};
+
+struct Scenario {
+    bool async;
+    LogFormat format;
+    bool mdc;
+    bool rotation;
+    bool console;
+
+    std::string name() const {
+        std::string n = async ? "async" : "sync";
+        n += format == LogFormat::Json ? "-json" : "-human";
+        n += mdc ? "-mdc" : "-nomdc";
+        n += rotation ? "-rotate" : "-norotate";
+        n += console ? "-console" : "-noconsole";
+        return n;
+    }
+};
+
+struct Percentiles {
+    double p50{0}, p99{0}, p999{0}, max{0};
+};
+
+struct Result {
+    Scenario scenario;
+    std::size_t threads;
+    std::size_t records;   // 总条数
+    double seconds;        // 吞吐轮：从开始到后端写空（含析构）
+    double records_per_s;
+    Percentiles call_ns;   // 生产者单次调用
+    Percentiles e2e_us;    // 采集时刻 -> 写入文件（writev 返回）
+};
+
+Percentiles percentiles(std::vector<std::int64_t>& v, double scale) {
+    Percentiles p;
+    if (v.empty()) return p;
+    std::sort(v.begin(), v.end());
+    auto at = [&](double q) {
+        std::size_t i = static_cast<std::size_t>(q * static_cast<double>(v.size() - 1));
+        return static_cast<double>(v[i]) / scale;
+    };
+    p.p50 = at(0.50);
+    p.p99 = at(0.99);
+    p.p999 = at(0.999);
+    p.max = static_cast<double>(v.back()) / scale;
+    return p;
+}
+
+// 端到端探针：包装真实文件 sink，批次写出（flush 返回）后记录每条的 采集->落盘 延迟
+class LatencyProbeSink : public LogSink {
+public:
+    explicit LatencyProbeSink(std::shared_ptr<FileSink> inner)
+        : LogSink(inner->format()), inner_(std::move(inner)) {}
+
+    void write(const LogEntry& entry) override {
+        inner_->write(entry);
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(entry.record.timestamp);
+    }
+
+    void flush() override {
+        inner_->flush_pending(); // 按批次立即写出，测量到 writev 返回为止
+        const auto now = std::chrono::system_clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& ts : pending_) {
+            samples_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - ts).count());
+        }
+        pending_.clear();
+    }
+
+    std::vector<std::int64_t> take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return std::move(samples_);
+    }
+
+private:
+    std::shared_ptr<FileSink> inner_;
+    std::mutex mutex_;
+    std::vector<std::chrono::system_clock::time_point> pending_;
+    std::vector<std::int64_t> samples_;
+};
+
+LoggerConfig make_config(const Scenario& s, const Options& opt, std::size_t threads) {
+    LoggerConfig cfg;
+    cfg.toFile = true;
+    cfg.filePath = opt.dir + "/" + s.name() + "-t" + std::to_string(threads) + ".log";
+    cfg.writeMode = FileWriteMode::Overwrite;
+    cfg.toConsole = s.console;
+    cfg.colorConsole = false;
+    cfg.asyncLogging = s.async;
+    cfg.logFormat = s.format;
+    cfg.includeMdc = s.mdc;
+    cfg.enableRotation = s.rotation;
+    cfg.maxFileSizeBytes = 8 * 1024 * 1024;
+    cfg.maxBackupFiles = 2;
+    return cfg;
+}
+
+// 各线程写 per_thread 条；measure 为 true 时记录每次调用耗时
+void produce(Logger* logger, bool mdc, std::size_t thread_index, std::size_t per_thread,
+             bool measure, std::vector<std::int64_t>* samples) {
+    if (mdc) {
+        XZeroMDC::put("traceId", "trace-" + std::to_string(thread_index));
+        XZeroMDC::put("sessionId", "session-bench");
+    }
+    if (measure) samples->reserve(per_thread);
+    for (std::size_t i = 0; i < per_thread; ++i) {
+        if (measure) {
+            const auto t0 = Clock::now();
+            XZERO_INFOF(logger, "bench thread={} seq={} payload=request completed status=200", thread_index, i);
+            const auto t1 = Clock::now();
+            samples->push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        } else {
+            XZERO_INFOF(logger, "bench thread={} seq={} payload=request completed status=200", thread_index, i);
+        }
+    }
+    if (mdc) XZeroMDC::clear();
+}
+
+template <typename Fn>
+void run_threads(std::size_t threads, Fn fn) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            fn(t);
+        });
+    }
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) w.join();
+}
+
+Result run_case(const Scenario& s, const Options& opt, std::size_t threads, std::size_t per_thread) {
+    Result r;
+    r.scenario = s;
+    r.threads = threads;
+    r.records = threads * per_thread;
+
+    // 吞吐轮：不计时单次调用；计时到日志器析构（队列写空、文件关闭）为止
+    {
+        const LoggerConfig cfg = make_config(s, opt, threads);
+        const auto begin = Clock::now();
+        {
+            std::unique_ptr<Logger> logger = XZeroLog().InitLogger(cfg);
+            run_threads(threads, [&](std::size_t t) {
+                produce(logger.get(), s.mdc, t, per_thread, false, nullptr);
+            });
+        }
+        r.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        r.records_per_s = static_cast<double>(r.records) / r.seconds;
+    }
+
+    // 延迟轮：单次调用耗时 + 端到端探针
+    {
+        LoggerConfig cfg = make_config(s, opt, threads);
+        LoggerConfig file_cfg = cfg;
+        file_cfg.filePath = opt.dir + "/" + s.name() + "-t" + std::to_string(threads) + "-e2e.log";
+        auto probe = std::make_shared<LatencyProbeSink>(FileSink::open_shared(file_cfg));
+        cfg.toFile = false;
+        cfg.sinks = {probe};
+        std::vector<std::vector<std::int64_t>> samples(threads);
+        {
+            std::unique_ptr<Logger> logger = XZeroLog().InitLogger(cfg);
+            run_threads(threads, [&](std::size_t t) {
+                produce(logger.get(), s.mdc, t, per_thread, true, &samples[t]);
+            });
+        }
+        std::vector<std::int64_t> all;
+        all.reserve(r.records);
+        for (auto& v : samples) all.insert(all.end(), v.begin(), v.end());
+        r.call_ns = percentiles(all, 1.0);
+        std::vector<std::int64_t> e2e = probe->take();
+        r.e2e_us = percentiles(e2e, 1000.0);
+    }
+    return r;
+}
+
+void print_csv_header(FILE* out) {
+    std::fprintf(out,
+                 "scenario,mode,format,mdc,rotation,console,threads,records,seconds,records_per_s,"
+                 "call_p50_ns,call_p99_ns,call_p999_ns,call_max_ns,"
+                 "e2e_p50_us,e2e_p99_us,e2e_p999_us,e2e_max_us\n");
+}
+
+void print_csv(FILE* out, const Result& r) {
+    const Scenario& s = r.scenario;
+    std::fprintf(out, "%s,%s,%s,%d,%d,%d,%zu,%zu,%.4f,%.0f,%.0f,%.0f,%.0f,%.0f,%.1f,%.1f,%.1f,%.1f\n",
+                 s.name().c_str(), s.async ? "async" : "sync",
+                 s.format == LogFormat::Json ? "json" : "human", s.mdc ? 1 : 0, s.rotation ? 1 : 0,
+                 s.console ? 1 : 0, r.threads, r.records, r.seconds, r.records_per_s,
+                 r.call_ns.p50, r.call_ns.p99, r.call_ns.p999, r.call_ns.max,
+                 r.e2e_us.p50, r.e2e_us.p99, r.e2e_us.p999, r.e2e_us.max);
+    std::fflush(out);
+}
+
+void print_json(FILE* out, const std::vector<Result>& results) {
+    std::fprintf(out, "[\n");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        const Scenario& s = r.scenario;
+        std::fprintf(out,
+                     "  {\"scenario\":\"%s\",\"mode\":\"%s\",\"format\":\"%s\",\"mdc\":%s,"
+                     "\"rotation\":%s,\"console\":%s,\"threads\":%zu,\"records\":%zu,"
+                     "\"seconds\":%.4f,\"records_per_s\":%.0f,"
+                     "\"call_ns\":{\"p50\":%.0f,\"p99\":%.0f,\"p999\":%.0f,\"max\":%.0f},"
+                     "\"e2e_us\":{\"p50\":%.1f,\"p99\":%.1f,\"p999\":%.1f,\"max\":%.1f}}%s\n",
+                     s.name().c_str(), s.async ? "async" : "sync",
+                     s.format == LogFormat::Json ? "json" : "human", s.mdc ? "true" : "false",
+                     s.rotation ? "true" : "false", s.console ? "true" : "false", r.threads,
+                     r.records, r.seconds, r.records_per_s, r.call_ns.p50, r.call_ns.p99,
+                     r.call_ns.p999, r.call_ns.max, r.e2e_us.p50, r.e2e_us.p99, r.e2e_us.p999,
+                     r.e2e_us.max, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "]\n");
+}
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--threads" && has_value) {
+            opt.max_threads = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--records" && has_value) {
+            opt.records = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--filter" && has_value) {
+            opt.filter = argv[++i];
+        } else if (arg == "--dir" && has_value) {
+            opt.dir = argv[++i];
+        } else if (arg == "--json") {
+            opt.json = true;
+        } else if (arg == "--quick") {
+            opt.quick = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        std::fprintf(stderr,
+                     "usage: %s [--threads N] [--records N] [--json] [--quick] [--filter S] [--dir D]\n",
+                     argv[0]);
+        return 2;
+    }
+    if (opt.max_threads == 0) {
+        const std::size_t hw = std::thread::hardware_concurrency();
+        opt.max_threads = hw == 0 ? 1 : (hw > 8 ? 8 : hw);
+    }
+    if (opt.quick && opt.records == 100000) opt.records = 20000;
+
+    std::vector<std::size_t> thread_counts;
+    if (opt.quick) {
+        thread_counts.push_back(1);
+        if (opt.max_threads > 1) thread_counts.push_back(opt.max_threads);
+    } else {
+        for (std::size_t t = 1; t < opt.max_threads; t *= 2) thread_counts.push_back(t);
+        thread_counts.push_back(opt.max_threads);
+    }
+
+    std::vector<Scenario> scenarios;
+    for (int a = 0; a < 2; ++a)
+        for (int f = 0; f < 2; ++f)
+            for (int m = 0; m < 2; ++m)
+                for (int r = 0; r < 2; ++r)
+                    for (int c = 0; c < 2; ++c) {
+                        Scenario s{a == 1, f == 1 ? LogFormat::Json : LogFormat::HumanFriendly,
+                                   m == 1, r == 1, c == 1};
+                        if (opt.filter.empty() || s.name().find(opt.filter) != std::string::npos) {
+                            scenarios.push_back(s);
+                        }
+                    }
+
+    // 结果写到原标准输出；控制台场景的日志输出丢弃
+    FILE* out = stdout;
+#if !defined(_WIN32)
+    const int result_fd = ::dup(1);
+    if (result_fd >= 0) {
+        out = ::fdopen(result_fd, "w");
+        if (!std::freopen("/dev/null", "w", stdout)) out = stdout;
+    }
+#endif
+
+    std::vector<Result> results;
+    if (!opt.json) print_csv_header(out);
+    for (const Scenario& s : scenarios) {
+        for (std::size_t threads : thread_counts) {
+            const std::size_t per_thread = opt.records;
+            Result r = run_case(s, opt, threads, per_thread);
+            if (opt.json) {
+                results.push_back(r);
+            } else {
+                print_csv(out, r);
+            }
+        }
+    }
+    if (opt.json) print_json(out, results);
+    std::fflush(out);
+    return 0;
+}
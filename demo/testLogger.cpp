@@ -1,6 +1,12 @@
 #include "Logger.h"
+#include "BasicLogger.h"
 #include "XZeroLog.h"
 #include "LogContext.h"
+#include "LogConfigWatcher.h"
+#include "LogRateLimit.h"
+#include "LoggerRegistry.h"
+#include "FileSink.h"
+#include "RingSink.h"
 
 #include <chrono>
 #include <iostream>
@@ -155,6 +161,11 @@ void run_all_tests() {
         XZeroMDC::put("traceId", "trace-abc-001");
         XZeroMDC::put("sessionId", "sess-xyz");
         XZERO_LOG(logger, LoggerLevel::INFO, "MDC 测试：携带 trace/session", 0);
+        {
+            XZeroMDC::Scope scope("userId", "u-42");
+            XZERO_LOG(logger, LoggerLevel::INFO, "MDC 测试：作用域内追加 userId", 0);
+        }
+        XZERO_LOG(logger, LoggerLevel::INFO, "MDC 测试：离开作用域后 userId 已移除", 0);
         XZeroMDC::clear();
     }
 
@@ -180,5 +191,283 @@ void run_all_tests() {
                   static_cast<int>(AppError::DiskFull));
     }
 
+    // 10) 延迟格式化：调用线程仅采集原始字段，由后台线程渲染
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/deferred.log";
+        cfg.asyncLogging = true;
+        cfg.deferredFormatting = true;
+        cfg.toConsole = false;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        XZeroMDC::put("traceId", "trace-deferred");
+        for (int i = 0; i < 5; ++i) {
+            XZERO_LOG(logger, LoggerLevel::INFO, "延迟格式化测试 第" + std::to_string(i) + "条", i);
+        }
+        XZeroMDC::clear();
+    }
+
+    // 11) 二进制格式：调用点只登记一次，可用 xzero_decode 还原为文本
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/binary.log";
+        cfg.logFormat = LogFormat::Binary;
+        cfg.writeMode = FileWriteMode::Overwrite;
+        cfg.toConsole = false;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        XZeroMDC::put("traceId", "trace-bin");
+        for (int i = 0; i < 5; ++i) {
+            XZERO_LOG(logger, LoggerLevel::INFO, "二进制格式测试", i);
+        }
+        XZERO_ERROR_E(logger, "二进制格式测试：磁盘空间不足", 2001);
+        XZeroMDC::clear();
+    }
+
+    // 12) 等级预检：被过滤等级的消息表达式不会被求值
+    {
+        LoggerConfig cfg;
+        cfg.onlyLevels = {LoggerLevel::ERROR};
+        cfg.toConsole = false;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        int evaluated = 0;
+        auto build_message = [&evaluated](int i) {
+            ++evaluated;
+            return "等级预检测试 第" + std::to_string(i) + "条";
+        };
+        for (int i = 0; i < 100; ++i) {
+            XZERO_DEBUG(logger, build_message(i));
+        }
+        XZERO_ERROR(logger, build_message(100));
+        std::cout << "等级预检：消息构造次数 = " << evaluated << "（期望 1）" << std::endl;
+    }
+
+    // 13) "{}" 占位符格式化：整数/浮点/字符串直接写入线程局部缓冲
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/logf.log";
+        cfg.toConsole = false;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        const std::string user = "alice";
+        XZERO_INFOF(logger, "请求完成 user={} latency={}us ratio={} ok={}", user, 1234, 0.25, true);
+        XZERO_ERRORF_E(logger, 1001, "连接 {}:{} 超时，字面量花括号 {{}}", "10.0.0.1", 8080);
+        logger->logf(LoggerLevel::WARN, "无源信息的格式化调用 id={}", -42);
+    }
+
+    // 14) 滚动备份后台压缩与清理：生成 compress.log.N.xzlz，最多保留 3 个、总计 16KB
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/compress.log";
+        cfg.toConsole = false;
+        cfg.writeMode = FileWriteMode::Overwrite;
+        cfg.enableRotation = true;
+        cfg.maxFileSizeBytes = 8 * 1024;
+        cfg.maxBackupFiles = 3;
+        cfg.backupCompression = BackupCompression::Lz4;
+        cfg.maxBackupTotalBytes = 16 * 1024;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        for (int i = 0; i < 500; ++i) {
+            XZERO_INFOF(logger, "压缩备份测试 第{}条", i);
+        }
+    }
+
+    // 15) 多 sink：同一条记录渲染一次后分发到主文件、独立线程的 Json 文件与内存环形 sink
+    {
+        auto ring = std::make_shared<RingSink>(16);
+        ring->set_level(LoggerLevel::WARN);
+        LoggerConfig jsonCfg;
+        jsonCfg.filePath = "build/logs/sinks.json.log";
+        jsonCfg.writeMode = FileWriteMode::Overwrite;
+        jsonCfg.logFormat = LogFormat::Json;
+        auto jsonFile = std::make_shared<AsyncSink>(std::make_shared<FileSink>(jsonCfg));
+
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/sinks.log";
+        cfg.toConsole = false;
+        cfg.sinks = {jsonFile, ring};
+        {
+            XZeroLog factory;
+            auto logger = factory.InitLogger(cfg);
+            XZERO_INFO(logger, "多 sink 测试：写入主文件与 Json 文件");
+            XZERO_WARN(logger, "多 sink 测试：同时进入内存环形 sink");
+        }
+        std::cout << "RingSink 保留 " << ring->size() << " 条（期望 1）" << std::endl;
+    }
+
+    // 16) 命名日志器：同一目标共享后端，等级按名称前缀继承
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/named.log";
+        cfg.writeMode = FileWriteMode::Overwrite;
+        cfg.toConsole = false;
+        LoggerRegistry& registry = LoggerRegistry::instance();
+        registry.configure("demo", cfg);
+        registry.set_level("demo.db", LoggerLevel::WARN);
+        XZERO_INFO(XZERO_NAMED_LOGGER("demo.http"), "命名日志器测试：http 组件");
+        XZERO_INFO(XZERO_NAMED_LOGGER("demo.db"), "命名日志器测试：被 WARN 等级过滤");
+        XZERO_WARN(XZERO_NAMED_LOGGER("demo.db"), "命名日志器测试：db 组件告警");
+    }
+
+    // 17) 运行时调整等级：直接修改等级掩码，或应用一段热加载配置文本
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/runtime_level.log";
+        cfg.writeMode = FileWriteMode::Overwrite;
+        cfg.toConsole = false;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        logger->set_level(LoggerLevel::WARN);
+        XZERO_INFO(logger, "不应出现：INFO 已被过滤");
+        LogConfigWatcher::apply("level = DEBUG\nformat.source = false\n", logger.get());
+        XZERO_DEBUG(logger, "热加载后 DEBUG 可见，且不含源信息");
+    }
+
+    // 18) 调用点限流与重复折叠：循环内的错误日志只输出突发额度，其余在下次放行时补报
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/rate_limit.log";
+        cfg.writeMode = FileWriteMode::Overwrite;
+        cfg.toConsole = false;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        for (int i = 0; i < 10000; ++i) {
+            XZERO_LOGF_RATE(logger, LoggerLevel::ERROR, 5, 3, 0, "下游不可用，第 {} 次重试", i);
+        }
+        const char* states[] = {"连接断开", "连接断开", "连接断开", "连接恢复"};
+        for (const char* state : states) {
+            XZERO_LOG_DEDUP(logger, LoggerLevel::WARN, std::string(state), 0);
+        }
+    }
+
+    // 19) 飞行记录器：DEBUG 平时不写出，出现 ERROR 时先转储最近的 DEBUG 上下文
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/flight_recorder.log";
+        cfg.writeMode = FileWriteMode::Overwrite;
+        cfg.toConsole = false;
+        cfg.onlyLevels = {LoggerLevel::WARN, LoggerLevel::ERROR};
+        cfg.flightRecorderSize = 4;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        for (int i = 0; i < 10; ++i) {
+            XZERO_DEBUGF(logger, "处理请求 第{}步", i);
+        }
+        XZERO_ERROR(logger, "请求失败：前面 4 条 DEBUG 已随本条一起写出");
+    }
+
+    // 20) 自身指标：写出一批记录后读取快照，并把 JSON 写进同一文件
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/stats.log";
+        cfg.writeMode = FileWriteMode::Overwrite;
+        cfg.toConsole = false;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        for (int i = 0; i < 1000; ++i) {
+            XZERO_INFOF(logger, "指标测试 第{}条", i);
+        }
+        XZERO_INFO(logger, "自身指标：" + logger->stats().to_json());
+    }
+
+    // 21) 背压：小队列 + Spill 策略，队列满时记录先写入溢出文件，分发线程追上后按序回放
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/spill.log";
+        cfg.writeMode = FileWriteMode::Overwrite;
+        cfg.toConsole = false;
+        cfg.queueCapacity = 16;
+        cfg.overflowPolicy = OverflowPolicy::Spill;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        for (int i = 0; i < 2000; ++i) {
+            XZERO_INFOF(logger, "溢出测试 第{}条", i);
+        }
+    }
+
+    // 22) 线程名：TID 为系统线程号，设置名称后附加在其后
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/thread_name.log";
+        cfg.writeMode = FileWriteMode::Overwrite;
+        cfg.toConsole = false;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        std::thread worker([&logger] {
+            XZeroLog::set_thread_name("demo-worker");
+            XZERO_INFO(logger, "线程名测试：来自命名线程");
+        });
+        worker.join();
+        XZERO_INFO(logger, "线程名测试：来自主线程");
+    }
+
+    // 23) 结构化字段：JSON 中为原生数值 / 布尔，Human-Friendly 中为 k=v
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/fields_json.log";
+        cfg.logFormat = LogFormat::Json;
+        cfg.writeMode = FileWriteMode::Overwrite;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        const std::string user = "alice";
+        logger->log(LoggerLevel::INFO, "结构化字段测试：请求完成",
+                    {{"status", 200}, {"latency_us", 1234.5}, {"ok", true}, {"user", user}});
+        XZERO_LOG_FIELDS(logger, LoggerLevel::WARN, "结构化字段测试：慢查询",
+                         {"table", "orders"}, {"rows", 120000u});
+    }
+
+    // 24) 编译期策略日志器：布局由模板参数固定，经工厂钩子以 Logger 接口使用
+    {
+        typedef BasicLogger<XZeroPolicy::Json, XZeroPolicy::FileOutput, XZeroPolicy::Async,
+                            XZeroPolicy::Time, XZeroPolicy::Level, XZeroPolicy::Thread,
+                            XZeroPolicy::Message, XZeroPolicy::KeyValues>
+            CompactJsonLogger;
+        LoggerConfig cfg;
+        cfg.filePath = "build/logs/basic_logger.log";
+        cfg.writeMode = FileWriteMode::Overwrite;
+        auto logger = BasicLoggerFactory<CompactJsonLogger>().InitLogger(cfg);
+        XZERO_INFO(logger, "策略日志器测试：紧凑 JSON");
+        XZERO_LOG_FIELDS(logger, LoggerLevel::WARN, "策略日志器测试：带字段", {"rows", 42});
+    }
+
+    // 25) 组提交落盘：多个线程的 ERROR 各自等待落盘，同一批共用一次 fdatasync
+    {
+        LoggerConfig cfg;
+        cfg.toFile = true;
+        cfg.filePath = "build/logs/durable.log";
+        cfg.writeMode = FileWriteMode::Overwrite;
+        cfg.toConsole = false;
+        cfg.durability = Durability::GroupCommit;
+        XZeroLog factory;
+        auto logger = factory.InitLogger(cfg);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&logger, t] {
+                for (int i = 0; i < 50; ++i) {
+                    XZERO_ERRORF(logger, "落盘测试 线程{} 第{}条", t, i);
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+        const LogStatsSnapshot s = logger->stats();
+        std::cout << "durable: " << s.written << " 条 / " << s.fsync_latency_ns.count
+                  << " 次落盘, p99 " << s.fsync_latency_ns.percentile(0.99) << " ns" << std::endl;
+    }
+
     std::cout << "=== Logger Tests Done ===" << std::endl;
 }
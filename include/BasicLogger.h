@@ -0,0 +1,480 @@
+#pragma once
+
+#include "LogConfig.h"
+#include "LogContext.h"
+#include "LogField.h"
+#include "LogFile.h"
+#include "LogSite.h"
+#include "LogThread.h"
+#include "LogTime.h"
+#include "Logger.h"
+#include "LoggerFactory.h"
+#include "MpscQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// 编译期定制的日志器：BasicLogger<格式策略, 输出策略, 线程策略, 字段...>
+// 输出布局（字段种类与顺序）、格式、输出目标与线程模型在编译期确定，渲染展开为逐字段的直线代码，
+// 不再逐条读取 logFormat / writeTime / includeSource / asyncLogging 等运行时开关；
+// 与 FileLogger 一样实现 Logger 接口，可经 BasicLoggerFactory 接入 LoggerFactory。
+// 仍在运行时生效的只有等级掩码（onlyLevels / disableLevels / set_level）。
+namespace XZeroPolicy {
+
+// 一次调用的参数，仅在渲染期间有效
+struct Call {
+    LoggerLevel level;
+    std::chrono::system_clock::time_point timestamp;
+    const char* message;
+    std::size_t length;
+    const LogField* fields;
+    std::size_t count;
+    int errorCode;
+    const char* file;
+    int line;
+    const char* func;
+    const LogSite* site; // 经宏记录时非空，源信息直接取预渲染片段
+};
+
+// 构造时确定、渲染时只读的环境
+struct Env {
+    TimePrecision precision{TimePrecision::Milliseconds};
+    ClockSource clock{ClockSource::System};
+    std::string platform_human; // "[Linux] "
+    std::string platform_json;  // ",\"OS\":\"Linux\""（已转义）
+
+    explicit Env(const LoggerConfig& cfg);
+};
+
+namespace detail {
+
+void append_int(std::string& out, long long v);
+void append_source(std::string& out, const Call& c);
+// 字段先编码到线程局部的暂存缓冲，再按格式渲染
+void append_fields_human(std::string& out, const LogField* fields, std::size_t count);
+void append_fields_json(std::string& out, const LogField* fields, std::size_t count);
+// 渲染目标：每个线程复用同一缓冲，稳定后不再分配
+std::string& line_buffer();
+
+template <typename T, typename... Ts>
+struct contains;
+template <typename T>
+struct contains<T> {
+    static const bool value = false;
+};
+template <typename T, typename U, typename... Ts>
+struct contains<T, U, Ts...> {
+    static const bool value = std::is_same<T, U>::value || contains<T, Ts...>::value;
+};
+
+} // namespace detail
+
+// ---- 字段：human() 写 Human-Friendly 片段，json() 写以逗号开头的 JSON 成员 ----
+
+struct Time {
+    static void human(std::string& out, const Call& c, const Env& env) {
+        char ts[XZeroTime::kMaxTimestampLen];
+        out.push_back('[');
+        out.append(ts, XZeroTime::format_local(c.timestamp, env.precision, ts));
+        out.append("] ", 2);
+    }
+    static void json(std::string& out, const Call& c, const Env& env) {
+        char ts[XZeroTime::kMaxTimestampLen];
+        out.append(",\"timestamp\":\"", 14);
+        out.append(ts, XZeroTime::format_utc(c.timestamp, env.precision, ts));
+        out.push_back('"');
+    }
+};
+
+struct Platform {
+    static void human(std::string& out, const Call&, const Env& env) { out.append(env.platform_human); }
+    static void json(std::string& out, const Call&, const Env& env) { out.append(env.platform_json); }
+};
+
+// 等级文本按枚举值查表，Human-Friendly 为定长 9 字节
+struct Level {
+    static void human(std::string& out, const Call& c, const Env&) {
+        static const char kText[4][10] = {"[INFO  ] ", "[DEBUG ] ", "[ERROR ] ", "[WARN  ] "};
+        out.append(kText[static_cast<unsigned>(c.level) & 3u], 9);
+    }
+    static void json(std::string& out, const Call& c, const Env&) {
+        static const char kText[4][20] = {",\"level\":\"INFO\"", ",\"level\":\"DEBUG\"",
+                                          ",\"level\":\"ERROR\"", ",\"level\":\"WARN\""};
+        static const std::size_t kLen[4] = {15, 16, 16, 15};
+        const unsigned i = static_cast<unsigned>(c.level) & 3u;
+        out.append(kText[i], kLen[i]);
+    }
+};
+
+struct Thread {
+    static void human(std::string& out, const Call&, const Env&) {
+        out.push_back('[');
+        out.append(XZeroThread::current().human);
+        out.append("] ", 2);
+    }
+    static void json(std::string& out, const Call&, const Env&) {
+        out.push_back(',');
+        out.append(XZeroThread::current().json);
+    }
+};
+
+// 源信息：无 file 时不输出
+struct Source {
+    static void human(std::string& out, const Call& c, const Env&) {
+        if (!c.file) return;
+        out.push_back('(');
+        if (c.site) {
+            out.append(c.site->source);
+        } else {
+            detail::append_source(out, c);
+        }
+        out.append(") - ", 4);
+    }
+    static void json(std::string& out, const Call& c, const Env&);
+};
+
+struct Message {
+    static void human(std::string& out, const Call& c, const Env&) { out.append(c.message, c.length); }
+    static void json(std::string& out, const Call& c, const Env&);
+};
+
+// 结构化字段（LogField），无字段时不输出
+struct KeyValues {
+    static void human(std::string& out, const Call& c, const Env&) {
+        if (c.count > 0) detail::append_fields_human(out, c.fields, c.count);
+    }
+    static void json(std::string& out, const Call& c, const Env&) {
+        if (c.count > 0) detail::append_fields_json(out, c.fields, c.count);
+    }
+};
+
+// MDC：直接取当前线程快照的预渲染片段
+struct Mdc {
+    static void human(std::string& out, const Call&, const Env&) {
+        const XZeroMDC::SnapshotPtr snap = XZeroMDC::snapshot();
+        if (snap) out.append(snap->human);
+    }
+    static void json(std::string& out, const Call&, const Env&) {
+        const XZeroMDC::SnapshotPtr snap = XZeroMDC::snapshot();
+        if (snap) out.append(snap->json);
+    }
+};
+
+struct ErrorCode {
+    static void human(std::string& out, const Call& c, const Env&) {
+        out.append(" (Error Code: ", 14);
+        detail::append_int(out, c.errorCode);
+        out.push_back(')');
+    }
+    static void json(std::string& out, const Call& c, const Env&) {
+        out.append(",\"error_code\":", 14);
+        detail::append_int(out, c.errorCode);
+    }
+};
+
+// ---- 格式：按字段声明顺序依次展开 ----
+
+struct Human {
+    template <typename... Fields>
+    static void render(std::string& out, const Call& c, const Env& env) {
+        using expand = int[];
+        (void)expand{0, (Fields::human(out, c, env), 0)...};
+    }
+};
+
+// 每个成员都以逗号开头，结束后把第一个逗号改写为 '{'，无需逐字段判断是否首个
+struct Json {
+    template <typename... Fields>
+    static void render(std::string& out, const Call& c, const Env& env) {
+        const std::size_t start = out.size();
+        using expand = int[];
+        (void)expand{0, (Fields::json(out, c, env), 0)...};
+        if (out.size() == start) {
+            out.push_back('{');
+        } else {
+            out[start] = '{';
+        }
+        out.push_back('}');
+    }
+};
+
+// ---- 输出：write() 追加一行（自动补换行），commit() 结束一批，flush() 立即写出 ----
+
+// 文件输出：原始 fd + 内部缓冲，commit() 按 flushPolicy 决定是否写出；不支持滚动与 Binary
+class FileOutput {
+public:
+    explicit FileOutput(const LoggerConfig& cfg);
+    ~FileOutput();
+
+    FileOutput(const FileOutput&) = delete;
+    FileOutput& operator=(const FileOutput&) = delete;
+
+    void write(const char* data, std::size_t n) {
+        file_.add_copy(data, n);
+        file_.add_copy("\n", 1);
+    }
+    void commit();
+    void flush();
+
+private:
+    LogFile file_;
+    std::string path_;
+    FlushPolicy policy_;
+    std::size_t bytes_threshold_;
+    std::chrono::milliseconds interval_;
+    std::chrono::steady_clock::time_point last_flush_;
+};
+
+// 控制台输出：stdout，不染色
+class ConsoleOutput {
+public:
+    explicit ConsoleOutput(const LoggerConfig&) {}
+
+    void write(const char* data, std::size_t n);
+    void commit();
+    void flush() { commit(); }
+};
+
+// 丢弃输出，只保留采集与渲染的开销（基准测试用）
+class NullOutput {
+public:
+    explicit NullOutput(const LoggerConfig&) {}
+
+    void write(const char*, std::size_t) {}
+    void commit() {}
+    void flush() {}
+};
+
+// ---- 线程模型：Writer<Output> 接收渲染好的一行 ----
+
+// 单线程：不加锁，调用方保证同一日志器不被并发使用
+struct SingleThread {
+    template <typename Output>
+    class Writer {
+    public:
+        explicit Writer(const LoggerConfig& cfg) : out_(cfg) {}
+
+        void submit(std::string& line) {
+            out_.write(line.data(), line.size());
+            out_.commit();
+        }
+        void flush() { out_.flush(); }
+
+    private:
+        Output out_;
+    };
+};
+
+// 同步加锁：调用线程渲染，互斥量只保护写出
+struct Locked {
+    template <typename Output>
+    class Writer {
+    public:
+        explicit Writer(const LoggerConfig& cfg) : out_(cfg) {}
+
+        void submit(std::string& line) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            out_.write(line.data(), line.size());
+            out_.commit();
+        }
+        void flush() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            out_.flush();
+        }
+
+    private:
+        std::mutex mutex_;
+        Output out_;
+    };
+};
+
+// 异步：调用线程渲染后把整行移入无锁队列（容量 queueCapacity，满时让出 CPU 重试），
+// 后台线程批量写出，每批 commit 一次；空闲时按 flushIntervalMs 兜底写出
+struct Async {
+    template <typename Output>
+    class Writer {
+    public:
+        explicit Writer(const LoggerConfig& cfg)
+            : out_(cfg), queue_(cfg.queueCapacity),
+              idle_wait_(cfg.flushIntervalMs > 0 ? cfg.flushIntervalMs : 1),
+              batch_(cfg.batchSize > 0 ? cfg.batchSize : 1) {
+            worker_ = std::thread(&Writer::worker_loop, this);
+        }
+
+        ~Writer() {
+            stop_.store(true, std::memory_order_release);
+            wake();
+            worker_.join();
+            out_.flush();
+        }
+
+        void submit(std::string& line) {
+            std::string moved(std::move(line));
+            while (!queue_.try_push(std::move(moved))) {
+                wake();
+                std::this_thread::yield();
+            }
+            submitted_.fetch_add(1, std::memory_order_relaxed);
+            line.clear();
+            if (sleeping_.load()) wake();
+        }
+
+        // 等待调用前已提交的行全部交给输出，再立即写出
+        void flush() {
+            const std::uint64_t target = submitted_.load(std::memory_order_relaxed);
+            while (written_.load(std::memory_order_acquire) < target) {
+                wake();
+                std::this_thread::yield();
+            }
+            std::lock_guard<std::mutex> lock(out_mutex_);
+            out_.flush();
+        }
+
+    private:
+        void wake() {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            cv_.notify_one();
+        }
+
+        void worker_loop() {
+            std::vector<std::string> lines;
+            lines.reserve(batch_);
+            while (true) {
+                lines.clear();
+                queue_.pop_bulk(std::back_inserter(lines), batch_);
+                if (!lines.empty()) {
+                    std::lock_guard<std::mutex> lock(out_mutex_);
+                    for (const std::string& line : lines) out_.write(line.data(), line.size());
+                    out_.commit();
+                    written_.fetch_add(lines.size(), std::memory_order_release);
+                    continue;
+                }
+                if (stop_.load(std::memory_order_acquire)) break;
+
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                sleeping_.store(true);
+                if (queue_.empty() && !stop_.load(std::memory_order_acquire)) {
+                    if (cv_.wait_for(lock, idle_wait_) == std::cv_status::timeout) {
+                        std::lock_guard<std::mutex> out_lock(out_mutex_);
+                        out_.flush();
+                    }
+                }
+                sleeping_.store(false);
+            }
+        }
+
+        Output out_;
+        std::mutex out_mutex_;
+        MpscQueue<std::string> queue_;
+        std::chrono::milliseconds idle_wait_;
+        std::size_t batch_;
+        std::mutex wake_mutex_;
+        std::condition_variable cv_;
+        std::atomic<bool> sleeping_{false};
+        std::atomic<bool> stop_{false};
+        std::atomic<std::uint64_t> submitted_{0}; // 成功入队的行数
+        std::atomic<std::uint64_t> written_{0};   // 已交给输出的行数
+        std::thread worker_;
+    };
+};
+
+} // namespace XZeroPolicy
+
+template <typename FormatPolicy, typename OutputPolicy, typename ThreadingPolicy, typename... Fields>
+class BasicLogger : public Logger {
+public:
+    explicit BasicLogger(const LoggerConfig& cfg) : env_(cfg), writer_(cfg) {
+        set_level_mask(level_mask_from(cfg));
+    }
+
+    void log(LoggerLevel level, const std::string& message,
+             int errorCode = 0,
+             const char* file = nullptr,
+             int line = 0,
+             const char* func = nullptr) const override {
+        emit(level, message.data(), message.size(), nullptr, 0, errorCode, file, line, func, nullptr);
+    }
+
+    void log_n(LoggerLevel level, const char* message, std::size_t length,
+               int errorCode = 0,
+               const char* file = nullptr,
+               int line = 0,
+               const char* func = nullptr) const override {
+        emit(level, message, length, nullptr, 0, errorCode, file, line, func, nullptr);
+    }
+
+    void log_fields(LoggerLevel level, const char* message, std::size_t length,
+                    const LogField* fields, std::size_t count,
+                    int errorCode = 0,
+                    const char* file = nullptr,
+                    int line = 0,
+                    const char* func = nullptr) const override {
+        emit(level, message, length, fields, count, errorCode, file, line, func, nullptr);
+    }
+    using Logger::log; // 保留带字段的重载
+
+    void log_site(const LogSite& site, LoggerLevel level,
+                  const char* message, std::size_t length,
+                  int errorCode = 0,
+                  const LogField* fields = nullptr,
+                  std::size_t count = 0) const override {
+        emit(level, message, length, fields, count, errorCode, site.file, site.line, site.func, &site);
+    }
+
+    // 立即写出缓冲（Async 先等待队列写空）
+    void flush() const { writer_.flush(); }
+
+private:
+    typedef typename ThreadingPolicy::template Writer<OutputPolicy> Writer;
+
+    void emit(LoggerLevel level, const char* message, std::size_t length,
+              const LogField* fields, std::size_t count,
+              int errorCode, const char* file, int line, const char* func,
+              const LogSite* site) const {
+        if (!level_enabled(level)) return;
+        XZeroPolicy::Call c{level, std::chrono::system_clock::time_point(), message, length,
+                            fields, count, errorCode, file, line, func, site};
+        // 布局中没有时间字段时不读时钟
+        if (XZeroPolicy::detail::contains<XZeroPolicy::Time, Fields...>::value) {
+            c.timestamp = XZeroTime::now(env_.clock);
+        }
+        std::string& line_buf = XZeroPolicy::detail::line_buffer();
+        line_buf.clear();
+        FormatPolicy::template render<Fields...>(line_buf, c, env_);
+        writer_.submit(line_buf);
+    }
+
+    const XZeroPolicy::Env env_;
+    mutable Writer writer_;
+};
+
+// 与 FileLogger 默认输出相同布局的预置组合
+typedef BasicLogger<XZeroPolicy::Human, XZeroPolicy::FileOutput, XZeroPolicy::Locked,
+                    XZeroPolicy::Time, XZeroPolicy::Platform, XZeroPolicy::Level,
+                    XZeroPolicy::Thread, XZeroPolicy::Source, XZeroPolicy::Message,
+                    XZeroPolicy::KeyValues, XZeroPolicy::Mdc, XZeroPolicy::ErrorCode>
+    HumanFileLogger;
+typedef BasicLogger<XZeroPolicy::Json, XZeroPolicy::FileOutput, XZeroPolicy::Locked,
+                    XZeroPolicy::Time, XZeroPolicy::Platform, XZeroPolicy::Level,
+                    XZeroPolicy::Thread, XZeroPolicy::Source, XZeroPolicy::Message,
+                    XZeroPolicy::KeyValues, XZeroPolicy::Mdc, XZeroPolicy::ErrorCode>
+    JsonFileLogger;
+
+// 工厂钩子：InitLogger() 构造指定的 BasicLogger 组合，可替换 XZeroLog 传给按 LoggerFactory 编写的代码
+template <typename L>
+class BasicLoggerFactory : public LoggerFactory {
+public:
+    std::unique_ptr<Logger> InitLogger(const LoggerConfig& config) override {
+        return std::unique_ptr<Logger>(new L(config));
+    }
+};
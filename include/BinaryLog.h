@@ -0,0 +1,100 @@
+#pragma once
+
+#include "LogRecord.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 二进制日志格式（LogFormat::Binary）
+// 每个文件自描述：调用点（file/line/func）与线程仅在首次出现时登记一次，
+// 之后的记录只写编号、增量时间戳与变长整数字段。
+//
+// 文件头:  'X' 'Z' 'L' 'B' | u8 版本 | str 平台 | varint 基准时间(微秒)
+// 记录:    u8 标签 + 负载
+//   0x01 调用点: varint site_id | str file | varint line | str func
+//   0x02 线程:   varint thread_idx | varint thread_id
+//   0x03 日志:   varint site_id | u8 level | u8 flags | [varint name_id]
+//                | zigzag 时间增量(微秒) | varint thread_idx | zigzag error_code
+//                | [str message] | [str fields] | varint mdc 个数 | (str key, str value)*
+//   0x04 日志器名: varint name_id | str name（版本 2 起）
+// str = varint 长度 + 字节；site_id 为 0 表示无源信息；
+// flags bit0：消息与该调用点上一条相同，省略 message 字段；
+// flags bit1：记录来自命名日志器，携带 name_id；
+// flags bit2：携带结构化字段（版本 3 起），fields 为 XZeroFields 编码（见 LogField.h）。
+// 解码器兼容版本 1（无日志器名）与版本 2（无字段）。
+// 追加模式下每次会话都会写入新的文件头，解码器据此重置登记表。
+namespace XZeroBinary {
+
+// 写入端：持有按文件登记的调用点/线程表，滚动后需 reset()
+class Encoder {
+public:
+    explicit Encoder(const std::string& platform);
+
+    // 将一条记录编码追加到 out（必要时先写文件头与登记记录）
+    void encode(const LogRecord& rec, std::string& out);
+    // 新文件开始：清空登记表，下一条记录前重写文件头
+    void reset();
+
+private:
+    struct SiteKey {
+        const char* file;
+        int line;
+        const char* func;
+        bool operator==(const SiteKey& o) const {
+            return file == o.file && line == o.line && func == o.func;
+        }
+    };
+    struct SiteKeyHash {
+        std::size_t operator()(const SiteKey& k) const;
+    };
+    struct SiteState {
+        std::uint64_t id;
+        std::string lastMessage;
+    };
+
+    // 写出调用点登记记录并分配编号
+    SiteState register_site(const LogRecord& rec, std::string& out);
+
+    std::string platform_;
+    bool header_written_{false};
+    std::int64_t last_us_{0};
+    std::uint64_t next_site_id_{1};
+    std::unordered_map<const LogSite*, SiteState> described_; // 带描述符的调用点，按指针登记
+    std::unordered_map<SiteKey, SiteState, SiteKeyHash> sites_; // 无描述符的调用点（直接调用 log()）
+    std::unordered_map<std::uint64_t, std::uint64_t> threads_;
+    std::unordered_map<std::string, std::uint64_t> names_;
+};
+
+// 读取端：解析任意数量的会话，逐条回调还原后的 LogRecord
+class Decoder {
+public:
+    using Callback = std::function<void(const LogRecord& rec, const std::string& platform)>;
+
+    // 解码整个缓冲区；数据损坏或截断时返回 false（已解出的记录仍会回调）
+    bool decode(const std::string& data, const Callback& cb);
+
+    // 判断缓冲区是否以二进制日志文件头开始
+    static bool looks_binary(const std::string& data);
+
+private:
+    struct Site {
+        std::string file;
+        int line;
+        std::string func;
+        std::string lastMessage;
+    };
+
+    std::string platform_;
+    std::int64_t last_us_{0};
+    std::deque<Site> sites_; // deque 保证元素地址稳定，LogRecord 可直接引用 c_str()
+    std::unordered_map<std::uint64_t, std::size_t> site_index_;
+    std::unordered_map<std::uint64_t, std::uint64_t> threads_;
+    std::unordered_map<std::uint64_t, std::string> names_;
+};
+
+} // namespace XZeroBinary
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "LogSink.h"
+
+#include <mutex>
+
+// 控制台输出：按级别染色（可关），每批 flush 一次 std::cout
+// Binary 配置下控制台仍输出 HumanFriendly 文本
+class ConsoleSink : public LogSink {
+public:
+    explicit ConsoleSink(const LoggerConfig& cfg);
+
+    void write(const LogEntry& entry) override;
+    void flush() override;
+
+private:
+    bool color_;
+    std::mutex mutex_;
+};
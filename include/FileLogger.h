@@ -1,22 +1,27 @@
 #pragma once
 
+#include "FlightRecorder.h"
+#include "LogBackend.h"
 #include "LogConfig.h"
-#include "LogUtils.h"
+#include "LogConfigWatcher.h"
+#include "LogFormatter.h"
+#include "LogSink.h"
 #include "Logger.h"
 
-#include <chrono>
-#include <condition_variable>
-#include <deque>
-#include <fstream>
-#include <mutex>
-#include <thread>
-#include <unordered_set>
+#include <memory>
+#include <string>
+#include <vector>
 
-// 线程安全的可配置日志器：支持文件/控制台输出、等级过滤、时间戳、错误码、滚动与异步批量
+// 线程安全的可配置日志器：自身只负责等级过滤与采集原始字段，输出交给共享的 LogBackend
+// 内置 sink 由 toConsole / toFile（enableRotation 时为滚动文件）生成，cfg.sinks 中的 sink 追加在后；
+// 输出目标相同的日志器共享同一个后端（队列、分发线程、文件句柄）。
 class FileLogger : public Logger {
 public:
     explicit FileLogger(const LoggerConfig& cfg);
-    ~FileLogger();
+    // 使用指定后端的命名日志器；name 非空时作为前缀写入每条记录
+    FileLogger(std::shared_ptr<LogBackend> backend, const LoggerConfig& cfg,
+               const std::string& name);
+    ~FileLogger() override;
 
     void log(LoggerLevel level, const std::string& message,
              int errorCode = 0,
@@ -24,31 +29,60 @@ public:
              int line = 0,
              const char* func = nullptr) const override;
 
+    void log_n(LoggerLevel level, const char* message, std::size_t length,
+               int errorCode = 0,
+               const char* file = nullptr,
+               int line = 0,
+               const char* func = nullptr) const override;
+
+    // 字段按类型编码进记录，由格式化器渲染（JSON 为原生值）
+    void log_fields(LoggerLevel level, const char* message, std::size_t length,
+                    const LogField* fields, std::size_t count,
+                    int errorCode = 0,
+                    const char* file = nullptr,
+                    int line = 0,
+                    const char* func = nullptr) const override;
+    using Logger::log; // 保留带字段的重载
+
+    // 记录保存描述符指针，格式化直接使用预渲染的源信息
+    void log_site(const LogSite& site, LoggerLevel level,
+                  const char* message, std::size_t length,
+                  int errorCode = 0,
+                  const LogField* fields = nullptr,
+                  std::size_t count = 0) const override;
+
+    // 交给后端定时（及析构时）补报
+    void defer_suppressed(XZeroRate::Suppression& suppression, const LogSite& site,
+                          LoggerLevel level) const override {
+        backend_->defer_suppressed(suppression, site, level, name_);
+    }
+
+    const std::string& name() const { return name_; }
+
+    // 运行时开关格式化字段（线程安全）；格式化器属于后端，对共享该后端的日志器一并生效
+    void set_format_flag(LogFormatter::FormatFlag flag, bool enabled) {
+        backend_->formatter().set_flag(flag, enabled);
+    }
+
+    // 所在后端的指标：共享同一后端的日志器看到相同的数值
+    LogStatsSnapshot stats() const override { return backend_->stats(); }
+
+    // 立即把飞行记录器中留存的记录交给后端写出；返回转储条数（未开启时为 0）
+    std::size_t dump_flight_recorder() const;
+
+    // 当前生效的全部 sink（内置在前）
+    const std::vector<std::shared_ptr<LogSink>>& sinks() const { return backend_->sinks(); }
+    const std::shared_ptr<LogBackend>& backend() const { return backend_; }
+
 private:
-    bool is_enabled(LoggerLevel level) const;
-    void ensure_separator_once() const;
-    void write_line_unlocked(const std::string& line, LoggerLevel level) const;
-    void worker_loop();
-    void rotate_if_needed(std::size_t next_line_len) const;
-    void rotate_files() const;
-
-    LoggerConfig config_;
-    mutable std::ofstream file_;
-    mutable std::mutex io_mutex_;      // 保护文件/控制台输出
-    mutable std::mutex queue_mutex_;   // 保护队列
-    mutable std::condition_variable cv_;
-    struct LogItem {
-        std::string text;
-        LoggerLevel level;
-    };
-    mutable std::deque<LogItem> queue_;
-    mutable bool stop_{false};
-    mutable bool separator_written_{false};
-    std::thread worker_;
-
-    std::unordered_set<LoggerLevel> disabled_;
-    std::unordered_set<LoggerLevel> only_;
-    std::string platform_;
-    mutable std::size_t current_size_{0};
-    mutable std::chrono::system_clock::time_point last_rotation_;
+    void capture(LoggerLevel level, const char* message, std::size_t length,
+                 const LogField* fields, std::size_t count, int errorCode,
+                 const char* file, int line, const char* func, const LogSite* site) const;
+
+    std::shared_ptr<LogBackend> backend_;
+    std::string name_;
+    ClockSource clock_source_;
+    std::unique_ptr<FlightRecorder> recorder_;  // cfg.flightRecorderSize > 0 时创建
+    LoggerLevel recorder_trigger_;
+    std::unique_ptr<LogConfigWatcher> watcher_; // cfg.watchConfigFile 非空时创建
 };
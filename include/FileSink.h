@@ -0,0 +1,87 @@
+#pragma once
+
+#include "BinaryLog.h"
+#include "LogFile.h"
+#include "LogMaintenance.h"
+#include "LogSink.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// 文件输出：原始 fd + 批量 writev（或 mmap），写出时机由 flushPolicy 控制
+// 使用 cfg 中的 filePath / writeMode / separator / flush* / useMmap / logFormat；
+// 构造时规范化路径、创建目录并打开文件，失败抛出 std::runtime_error。
+class FileSink : public LogSink {
+public:
+    explicit FileSink(const LoggerConfig& cfg);
+    ~FileSink() override;
+
+    // 按规范化路径共享文件 sink：同一路径在进程内只打开一个句柄（enableRotation 时为 RotatingFileSink）
+    // 已存在时直接复用；格式、写入模式、flush/落盘、滚动与 mmap 配置须与首次打开时一致，否则抛出 std::runtime_error
+    static std::shared_ptr<FileSink> open_shared(const LoggerConfig& cfg);
+
+    void write(const LogEntry& entry) override;
+    void flush() override;
+    void on_idle() override;
+    void flush_pending() override;
+    void sync() override;
+    void emergency_flush() override;
+    void collect_stats(LogStatsSnapshot& out) const override;
+
+    const std::string& path() const { return config_.filePath; }
+
+protected:
+    // 写入前的钩子（持锁调用）：返回 true 表示已切换到新文件
+    virtual bool before_write(std::size_t next_len) {
+        (void)next_len;
+        return false;
+    }
+    // 供滚动使用（持锁调用）：写出缓冲并关闭当前文件；以截断方式重新打开并重置按文件状态
+    void close_file();
+    void reopen_truncated();
+
+    LoggerConfig config_;
+    std::size_t current_size_{0};
+    std::atomic<std::uint64_t> rotations_{0};
+
+private:
+    bool open_file(bool truncate);
+    void ensure_separator_once();
+    bool write_out(); // 持锁调用：写出缓冲并记录耗时
+    bool sync_out();  // 持锁调用：写出缓冲后落盘并记录落盘耗时
+
+
+    std::mutex mutex_;
+    LogFile file_;
+    bool separator_written_{false};
+    XZeroBinary::Encoder encoder_; // Binary 格式的按文件登记状态
+    std::string encoded_;          // 编码缓冲，复用以减少分配
+    std::chrono::steady_clock::time_point last_flush_;
+    std::atomic<std::uint64_t> bytes_written_{0}; // 交给文件的字节数（含分割线）
+    LogHistogram write_latency_ns_;               // 每次 writev 写出耗时；mmap 模式无系统调用，不计
+    LogHistogram fsync_latency_ns_;               // 每次落盘（fdatasync / msync）耗时
+};
+
+// 滚动文件输出：按 maxFileSizeBytes / rotationIntervalSeconds 切换文件
+// 写线程只做一次 rename，备份轮转、压缩与清理交给 LogMaintenance 后台线程
+class RotatingFileSink : public FileSink {
+public:
+    explicit RotatingFileSink(const LoggerConfig& cfg);
+
+    // 等待已提交的备份任务完成（测试/演示用）
+    void wait_maintenance();
+
+protected:
+    bool before_write(std::size_t next_len) override;
+
+private:
+    void rotate_files();
+
+    std::chrono::system_clock::time_point last_rotation_;
+    std::unique_ptr<LogMaintenance> maintenance_;
+};
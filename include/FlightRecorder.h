@@ -0,0 +1,60 @@
+#pragma once
+
+#include "LogRecord.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 飞行记录器：在内存环形缓冲中留存被等级过滤掉的最近 N 条原始记录（通常是 DEBUG），
+// 平时不格式化、不写盘；出现 ERROR（触发等级）、调用 dump 接口或收到信号时，
+// 按采集顺序取出交给后端，与普通记录走同一条格式化与 sink 分发流程。
+// 写入：一次 fetch_add 取得槽位 + 该槽位的自旋锁（仅与转储或绕圈的写者竞争）。
+class FlightRecorder {
+public:
+    explicit FlightRecorder(std::size_t capacity);
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // 留存一条记录；满后覆盖最旧的
+    void record(LogRecord&& rec);
+
+    // 取出全部留存记录（按采集顺序）并清空
+    std::vector<LogRecord> drain();
+
+    // 是否有尚未处理的全局转储请求
+    bool dump_requested() const {
+        return dump_generation_.load(std::memory_order_relaxed) !=
+               seen_generation_.load(std::memory_order_relaxed);
+    }
+    // 标记当前全局请求已处理；返回 true 表示由本次调用认领
+    bool acknowledge_request();
+
+    // 请求所有飞行记录器转储（异步信号安全，可在信号处理函数中调用）；
+    // 异步模式由后端分发线程在唤醒或空闲超时时执行，进程空闲或调用线程卡住时也能转储；
+    // 同步模式在该日志器下一次记录日志时执行
+    static void request_dump_all();
+    // 全局转储请求计数，分发线程据此廉价判断是否有新请求
+    static unsigned request_generation() { return dump_generation_.load(std::memory_order_relaxed); }
+    // 安装信号处理：收到 signo（如 SIGUSR2）时调用 request_dump_all()；失败抛出 std::runtime_error
+    static void install_dump_signal(int signo);
+
+private:
+    struct Slot {
+        std::atomic<bool> busy{false};
+        bool used{false};
+        std::uint64_t seq{0};
+        LogRecord rec;
+    };
+
+    // 全局转储请求计数；常量初始化的无锁原子，信号处理函数中读写安全
+    static std::atomic<unsigned> dump_generation_;
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t capacity_;
+    std::atomic<std::uint64_t> head_{0};
+    std::atomic<unsigned> seen_generation_;
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+// 轻量类型安全格式化：支持 "{}" 占位符（"{{" / "}}" 输出字面量花括号）
+// 结果写入固定容量的内联缓冲，超出容量时才回退到堆；整数/浮点/字符串直接写入，不产生临时对象。
+// 自定义类型可在其命名空间内提供 void format_arg(XZeroFmt::Buffer&, const T&)，通过 ADL 被找到。
+namespace XZeroFmt {
+
+class Buffer {
+public:
+    static const std::size_t kInlineCapacity = 1024;
+
+    Buffer() = default;
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    void append(const char* s, std::size_t n) {
+        if (on_heap_) {
+            heap_.append(s, n);
+        } else if (size_ + n <= kInlineCapacity) {
+            std::memcpy(inline_ + size_, s, n);
+            size_ += n;
+        } else {
+            spill(s, n);
+        }
+    }
+
+    void push_back(char c) { append(&c, 1); }
+
+    const char* data() const { return on_heap_ ? heap_.data() : inline_; }
+    std::size_t size() const { return on_heap_ ? heap_.size() : size_; }
+
+    // 清空内容；堆缓冲保留容量供下次复用
+    void clear() {
+        size_ = 0;
+        on_heap_ = false;
+        heap_.clear();
+    }
+
+private:
+    // 内联空间不足：整体迁移到堆
+    void spill(const char* s, std::size_t n) {
+        heap_.reserve(size_ + n > 2 * kInlineCapacity ? size_ + n : 2 * kInlineCapacity);
+        heap_.assign(inline_, size_);
+        heap_.append(s, n);
+        on_heap_ = true;
+    }
+
+    char inline_[kInlineCapacity];
+    std::size_t size_{0};
+    bool on_heap_{false};
+    std::string heap_;
+};
+
+// 内置类型的格式化（数值实现在 FormatBuffer.cpp，无堆分配）
+void format_arg(Buffer& out, long long value);
+void format_arg(Buffer& out, unsigned long long value);
+void format_arg(Buffer& out, double value);
+void format_arg(Buffer& out, long double value);
+void format_arg(Buffer& out, const void* value);
+
+inline void format_arg(Buffer& out, int value) { format_arg(out, static_cast<long long>(value)); }
+inline void format_arg(Buffer& out, long value) { format_arg(out, static_cast<long long>(value)); }
+inline void format_arg(Buffer& out, unsigned value) {
+    format_arg(out, static_cast<unsigned long long>(value));
+}
+inline void format_arg(Buffer& out, unsigned long value) {
+    format_arg(out, static_cast<unsigned long long>(value));
+}
+inline void format_arg(Buffer& out, bool value) {
+    if (value) out.append("true", 4); else out.append("false", 5);
+}
+inline void format_arg(Buffer& out, char value) { out.push_back(value); }
+inline void format_arg(Buffer& out, const char* value) {
+    if (value) out.append(value, std::strlen(value)); else out.append("(null)", 6);
+}
+inline void format_arg(Buffer& out, const std::string& value) { out.append(value.data(), value.size()); }
+inline void format_arg(Buffer& out, std::nullptr_t) { out.append("nullptr", 7); }
+
+// 将 [begin, end) 作为字面量追加，处理 "{{" / "}}" 转义
+inline void append_literal(Buffer& out, const char* begin, const char* end) {
+    const char* run = begin;
+    for (const char* p = begin; p < end; ++p) {
+        if ((p[0] == '{' || p[0] == '}') && p + 1 < end && p[1] == p[0]) {
+            out.append(run, static_cast<std::size_t>(p + 1 - run));
+            ++p;
+            run = p + 1;
+        }
+    }
+    out.append(run, static_cast<std::size_t>(end - run));
+}
+
+// 查找下一个未转义的 "{}"；找不到返回 nullptr
+inline const char* find_placeholder(const char* p) {
+    for (; *p; ++p) {
+        if ((p[0] == '{' || p[0] == '}') && p[1] == p[0]) {
+            ++p; // 跳过转义
+        } else if (p[0] == '{' && p[1] == '}') {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+// 参数已用尽：剩余部分（含多余的 "{}"）按字面量输出
+inline void format_to(Buffer& out, const char* fmt) {
+    append_literal(out, fmt, fmt + std::strlen(fmt));
+}
+
+template <typename T, typename... Rest>
+void format_to(Buffer& out, const char* fmt, const T& first, const Rest&... rest) {
+    const char* ph = find_placeholder(fmt);
+    if (!ph) {
+        // 占位符少于参数：多余参数忽略
+        format_to(out, fmt);
+        return;
+    }
+    append_literal(out, fmt, ph);
+    format_arg(out, first);
+    format_to(out, ph + 2, rest...);
+}
+
+// 线程局部缓冲的作用域租借；同一线程重入（如自定义 format_arg 内部再次记录日志）时改用自带缓冲
+class ScopedBuffer {
+public:
+    ScopedBuffer() : buf_(acquire()) { buf_.clear(); }
+    ~ScopedBuffer() {
+        if (&buf_ == &thread_buffer()) in_use() = false;
+    }
+    ScopedBuffer(const ScopedBuffer&) = delete;
+    ScopedBuffer& operator=(const ScopedBuffer&) = delete;
+
+    Buffer& get() { return buf_; }
+
+private:
+    static Buffer& thread_buffer() {
+        static thread_local Buffer buf;
+        return buf;
+    }
+    static bool& in_use() {
+        static thread_local bool flag = false;
+        return flag;
+    }
+    Buffer& acquire() {
+        if (in_use()) return fallback_;
+        in_use() = true;
+        return thread_buffer();
+    }
+
+    Buffer fallback_;
+    Buffer& buf_;
+};
+
+// 仅用于 sizeof 的不求值上下文，使被编译期裁剪的格式化宏不产生未使用告警
+template <typename... Args>
+int discard(const Args&...);
+
+} // namespace XZeroFmt
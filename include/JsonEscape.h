@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// JSON 字符串转义：'"'、'\\' 与全部 0x00-0x1F 控制字符
+// 按 CPU 能力在运行时选择 AVX2 / SSE2 / 标量实现，一次扫描 16~32 字节，无需转义的片段整体拷贝
+namespace XZeroJson {
+
+// 将 data 转义后追加到 out（不含两侧引号）
+void escape_append(std::string& out, const char* data, std::size_t n);
+
+inline void escape_append(std::string& out, const std::string& s) {
+    escape_append(out, s.data(), s.size());
+}
+
+// 当前选用的实现："avx2" / "sse2" / "scalar"
+const char* escape_impl_name();
+
+// 各实现的直接入口（供基准测试对比）；CPU 不支持时返回 false 且不写入
+void escape_append_scalar(std::string& out, const char* data, std::size_t n);
+bool escape_append_sse2(std::string& out, const char* data, std::size_t n);
+bool escape_append_avx2(std::string& out, const char* data, std::size_t n);
+
+} // namespace XZeroJson
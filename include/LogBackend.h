@@ -0,0 +1,193 @@
+#pragma once
+
+#include "LogConfig.h"
+#include "LogFormatter.h"
+#include "LogSink.h"
+#include "LogStats.h"
+#include "MpscQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class FlightRecorder;
+struct LogSite;
+namespace XZeroRate {
+class Suppression;
+} // namespace XZeroRate
+
+// 日志后端：sink 集合 + 异步队列 + 分发线程
+// 同一输出目标（文件路径 / 控制台）且配置相同的日志器通过 acquire() 共享同一个后端，
+// 避免每个日志器各起一个线程、各持一个文件句柄，也避免多个日志器对同一文件并发滚动。
+// 后端随最后一个引用它的日志器析构，析构时写出队列中剩余的记录。
+class LogBackend {
+public:
+    // GroupCommit 的落盘票据：等待的调用线程在自己栈上持有，本批落盘后由分发方置位
+    struct DurableTicket {
+        bool done{false}; // 受 durable_mutex_ 保护
+    };
+
+    struct Item {
+        LogEntry entry;        // 原始字段 + 渲染后的文本
+        bool formatted{false}; // 文本是否已就绪（延迟格式化时由分发线程填充）
+        DurableTicket* ticket{nullptr}; // 非空表示调用线程在等待本条落盘；这类记录不丢弃
+    };
+
+    explicit LogBackend(const LoggerConfig& cfg);
+    ~LogBackend();
+
+    LogBackend(const LogBackend&) = delete;
+    LogBackend& operator=(const LogBackend&) = delete;
+
+    // 按输出目标与后端相关配置（格式、异步、落盘、崩溃保护等）查找或创建共享后端；
+    // 同一目标上配置不同的日志器得到各自的后端，共用的文件须以相同的文件配置打开，否则抛出 std::runtime_error。
+    // 携带自定义 sinks 的配置使用独立后端（其中的文件仍按路径共享同一个 FileSink）。
+    static std::shared_ptr<LogBackend> acquire(const LoggerConfig& cfg);
+
+    // 提交一条记录：异步模式入队，同步模式直接分发
+    // cfg.durability 为 GroupCommit 且等级不低于 durabilityLevel 时，返回前等待本条落盘
+    void submit(Item&& item) const;
+
+    // 等待队列写空并写出各 sink 的缓冲（开启落盘保证时一并落盘），最多等待 timeout_ms（进程退出钩子使用）
+    void drain(std::size_t timeout_ms) const;
+    // 致命信号处理函数中调用（cfg.crashHandler）：仅使用异步信号安全操作，
+    // 把 sink 缓冲、分发线程手中的批次与队列中的记录写到预先打开的崩溃 fd
+    void emergency_drain(int signo) const;
+
+    // 登记 / 注销日志器的飞行记录器：异步模式下分发线程发现全局转储请求（信号、request_dump_all）时
+    // 在自己的线程上转储，不依赖该日志器再次记录日志；注销在转储进行中时等待其结束
+    void attach_recorder(FlightRecorder* recorder, const std::string& logger);
+    void detach_recorder(FlightRecorder* recorder);
+    // 取出飞行记录器中的记录，前后加标记行后提交；返回转储条数（调用线程使用）
+    std::size_t dump_recorder(FlightRecorder& recorder, const std::string& logger) const;
+
+    // 登记调用点的抑制计数（限流 / 折叠宏）：异步模式由分发线程约每秒补报一次，
+    // 同步模式在之后的写出时补报；两种模式析构时都补报剩余条数
+    void defer_suppressed(XZeroRate::Suppression& suppression, const LogSite& site,
+                          LoggerLevel level, const std::string& logger) const;
+
+    // 自身指标快照：后端计数 + 各 sink 的写出统计（见 LogStatsSnapshot）
+    LogStatsSnapshot stats() const;
+    // 日志器在等级检查处拒绝一条记录时调用（计入 filtered）
+    void record_filtered() const { filtered_.fetch_add(1, std::memory_order_relaxed); }
+
+    const LoggerConfig& config() const { return config_; }
+    // 共享的格式化器；其字段开关可在运行时调整，对使用该后端的全部日志器生效
+    LogFormatter& formatter() { return formatter_; }
+    const std::vector<std::shared_ptr<LogSink>>& sinks() const { return sinks_; }
+
+private:
+    void render(Item& item) const;                       // 按 sink 需要的格式各渲染一次
+    void dispatch(Item* items, std::size_t n) const;      // 分发到全部 sink
+    void worker_loop();
+    void enqueue(Item&& item) const;
+    bool wait_for_slot(Item& item) const;                // 按 overflowPolicy 处理队列满；返回是否已入队
+    void notify_slot_waiters() const;                    // 分发线程取走一批后唤醒挂起的生产者
+    bool spill(const Item& item) const;                  // 写入溢出文件；超出上限时返回 false
+    std::size_t replay_spill(std::vector<Item>& batch);  // 分发线程：从溢出文件按序读回一批
+    void shed_oldest(std::vector<Item>& batch);          // DropOldest：丢弃批次中的非 ERROR 记录
+    void wake_worker() const;
+    // 有新的丢弃时（至多每秒一次）补报一条 WARN 记录；force 时忽略间隔
+    void report_drops(bool force);
+    // 取出记录并前后加标记行；标记沿用转储记录中最低的等级，不冒充 ERROR
+    std::vector<Item> make_dump(std::vector<LogRecord>&& records, const std::string& logger) const;
+    // 分发线程：有新的全局转储请求时，转储各登记的飞行记录器并直接分发
+    void dump_requested_recorders();
+    // 取出已登记调用点的抑制计数并各写出一条汇总记录（至多每秒一次）；force 时忽略间隔
+    void report_suppressed(bool force) const;
+    // cfg.statsIntervalMs 到期时把指标快照作为一条记录写出
+    void maybe_emit_stats(std::chrono::steady_clock::time_point now) const;
+
+    // 落盘保证（cfg.durability）：分发线程或持 dispatch_mutex_ 的线程调用
+    bool needs_durable(LoggerLevel level) const;                  // 等级是否触发 OnError / GroupCommit
+    bool batch_urgent(const Item* items, std::size_t n) const;    // 本批写出后是否须立即落盘
+    void commit(bool urgent, std::chrono::steady_clock::time_point now) const; // 按模式决定是否落盘
+    void sync_sinks(std::chrono::steady_clock::time_point now) const;
+    void release_tickets(const Item* items, std::size_t n) const; // 唤醒本批的等待者
+    void group_commit(std::uint64_t seq) const;                   // 同步模式：一次落盘覆盖已分发的全部记录
+
+    LoggerConfig config_;
+    std::vector<std::shared_ptr<LogSink>> sinks_;
+    std::vector<LogSink*> direct_sinks_;   // 在分发线程上直接写入
+    std::vector<LogSink*> threaded_sinks_; // 拥有独立写线程，移交共享所有权
+    bool need_human_{false};
+    bool need_json_{false};
+    mutable std::mutex dispatch_mutex_;    // 同步模式下串行化分发
+    mutable std::mutex wake_mutex_;        // 仅用于后台线程休眠/唤醒，不保护队列
+    mutable std::condition_variable cv_;
+    std::unique_ptr<MpscQueue<Item>> queue_; // 无锁有界队列，仅异步模式创建
+    mutable std::atomic<bool> sleeping_{false}; // 后台线程是否处于等待
+    std::atomic<bool> stop_{false};
+    std::thread worker_;
+
+    int crash_fd_{-1};                  // cfg.crashHandler 时预先打开
+    bool crash_fd_owned_{false};        // 为 stderr 时不关闭
+    std::atomic<const Item*> inflight_{nullptr}; // 分发线程正在写出的批次（仅崩溃保护开启时维护）
+    std::atomic<std::size_t> inflight_count_{0};
+    mutable std::atomic<bool> frozen_{false}; // 崩溃抢救期间令分发线程停在安全点，不再移动记录
+    std::atomic<bool> parked_{false};
+
+    // 自身指标：均为 relaxed 原子计数；生产者侧只在慢路径上触碰
+    // 异步模式的入队数直接取自队列的入队序号，不额外计数
+    mutable std::atomic<std::uint64_t> sync_submitted_{0};
+    mutable std::atomic<std::uint64_t> written_{0};
+    mutable std::atomic<std::uint64_t> filtered_{0};
+    mutable std::atomic<std::uint64_t> dropped_{0};
+    mutable std::atomic<std::uint64_t> spilled_{0};
+    mutable std::atomic<std::uint64_t> queue_full_waits_{0};
+    std::atomic<std::uint64_t> queue_high_water_{0}; // 仅分发线程写
+    mutable LogHistogram batch_size_;
+    mutable LogHistogram batch_latency_ns_;
+    mutable std::chrono::steady_clock::time_point next_stats_; // 受分发线程或 dispatch_mutex_ 保护
+
+    // 背压：DropOldest 的丢弃请求与 Spill 的溢出文件（读写偏移均受 spill_mutex_ 保护）
+    // 队列满时挂起的生产者：短暂自旋后等待 slot_cv_，分发线程仅在有等待者时加锁通知
+    mutable std::mutex slot_mutex_;
+    mutable std::condition_variable slot_cv_;
+    mutable std::atomic<unsigned> slot_waiters_{0};
+    mutable std::atomic<bool> shed_{false};
+    mutable std::atomic<bool> spill_active_{false}; // 溢出文件中有未回放的记录，新记录也须先写入文件以保序
+    mutable std::mutex spill_mutex_;
+    std::FILE* spill_file_{nullptr};
+    mutable std::size_t spill_read_{0};
+    mutable std::size_t spill_write_{0};
+    std::string spill_buf_;
+    std::uint64_t reported_drops_{0};
+    // 限流 / 折叠：等待补报的调用点（受 suppress_mutex_ 保护），汇总记录的时间受分发线程或 dispatch_mutex_ 保护
+    struct PendingSuppression {
+        XZeroRate::Suppression* suppression;
+        const LogSite* site;
+        LoggerLevel level;
+        std::string logger;
+    };
+    mutable std::mutex suppress_mutex_;
+    mutable std::vector<PendingSuppression> suppressions_;
+    mutable std::chrono::steady_clock::time_point next_suppress_report_;
+    // 飞行记录器：登记表受 recorder_mutex_ 保护，已处理的请求计数仅分发线程访问
+    std::mutex recorder_mutex_;
+    std::vector<std::pair<FlightRecorder*, std::string>> recorders_;
+    unsigned seen_dump_generation_{0};
+    std::chrono::steady_clock::time_point next_drop_report_;
+
+    // 落盘保证：unsynced_ / last_sync_ 受分发线程或 dispatch_mutex_ 保护
+    mutable bool unsynced_{false}; // 有已写出但尚未落盘的记录
+    mutable std::chrono::steady_clock::time_point last_sync_;
+    mutable std::mutex durable_mutex_; // 保护票据状态
+    mutable std::condition_variable durable_cv_;
+    // 同步模式的组提交：分发序号在 dispatch_mutex_ 内递增，已落盘序号受 commit_mutex_ 保护
+    mutable std::atomic<std::uint64_t> dispatched_seq_{0};
+    mutable std::uint64_t durable_seq_{0};
+    mutable std::mutex commit_mutex_;
+
+    std::string platform_;
+    LogFormatter formatter_;
+};
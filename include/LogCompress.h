@@ -0,0 +1,41 @@
+#pragma once
+
+#include "LogConfig.h"
+
+#include <cstddef>
+#include <string>
+
+// 滚动备份的压缩/解压
+// - Lz4：内置 LZ4 风格块压缩（贪心哈希匹配，64KB 窗口），无外部依赖，输出 .xzlz 容器
+// - Gzip：需构建时找到 zlib（XZEROLOG_HAVE_ZLIB），否则回退 Lz4
+//
+// .xzlz 容器：'X' 'Z' 'L' 'Z' | u8 版本 | 块* | u32 0
+//   块 = u32 原始长度 | u32 存储长度 | 数据（存储长度等于原始长度时为未压缩原文）
+//   整数均为小端；单块原始长度不超过 kBlockSize
+namespace XZeroCompress {
+
+const std::size_t kBlockSize = 1024 * 1024;
+
+// 压缩算法实际生效的取值（Gzip 在无 zlib 时回退为 Lz4）
+BackupCompression effective(BackupCompression kind);
+
+// 备份文件后缀：""、".xzlz"、".gz"
+const char* extension(BackupCompression kind);
+
+// 将 src 压缩写入 dst；失败时删除不完整的 dst 并返回 false
+bool compress_file(const std::string& src, const std::string& dst, BackupCompression kind);
+
+// 判断缓冲区是否为可识别的压缩数据（.xzlz 或 gzip）
+bool looks_compressed(const std::string& data);
+
+// 解压整个缓冲区；格式无法识别或数据损坏时返回 false
+bool decompress(const std::string& data, std::string& out);
+
+// LZ4 块格式单块压缩/解压（供测试与基准直接调用）
+std::size_t lz4_bound(std::size_t n);
+// dst 至少 lz4_bound(n) 字节；返回压缩后长度
+std::size_t lz4_compress_block(const char* src, std::size_t n, char* dst);
+// 解压为恰好 raw_len 字节；数据损坏返回 false
+bool lz4_decompress_block(const char* src, std::size_t n, char* dst, std::size_t raw_len);
+
+} // namespace XZeroCompress
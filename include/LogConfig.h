@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -18,12 +19,60 @@ enum class FileWriteMode {
     Overwrite,
 };
 
-// 输出格式：人类可读或 JSON
+// 输出格式：人类可读、JSON 或紧凑二进制（需 xzero_decode 还原）
 enum class LogFormat {
     HumanFriendly,
     Json,
+    Binary,
 };
 
+// 文件写出策略：写线程先聚合为 iovec，再按策略一次 writev
+enum class FlushPolicy {
+    EveryBatch,  // 每批写出一次（默认）
+    EveryNBytes, // 缓冲达到 flushBytesThreshold 字节时写出
+    Interval,    // 距上次写出超过 flushTimeIntervalMs 时写出
+};
+
+// 异步队列满时的处理策略（丢弃的条数计入 stats().dropped，并由分发线程以 WARN 记录补报）
+enum class OverflowPolicy {
+    Block,      // 挂起生产者直到腾出槽位（短暂自旋后等待分发线程唤醒）；blockTimeoutMs 非 0 时超时丢弃本条（默认，一直等待）
+    DropNewest, // 立即丢弃本条
+    DropOldest, // 令分发线程丢弃队列中最旧的非 ERROR 记录腾出空间；ERROR 不丢
+    Spill,      // 本条顺序写入溢出文件，分发线程追上后按序回放
+};
+
+// 落盘保证：写出（writev）只把数据交给页缓存，掉电时仍会丢失；以下模式在写出之后再调用 fdatasync
+// 仅作用于后端直接写入的 sink（文件）；AsyncSink 包装的 sink 在自己的线程上写出，不在保证之内
+enum class Durability {
+    None,        // 不主动落盘，由操作系统择机回写（默认）
+    Interval,    // 距上次落盘超过 durabilityIntervalMs 时落盘（空闲时兜底），掉电最多丢失这段时间的记录
+    OnError,     // 批次中含不低于 durabilityLevel 的记录时，写出后立即落盘
+    GroupCommit, // 不低于 durabilityLevel 的记录落盘后调用才返回；同一批等待者共用一次 fdatasync
+};
+
+// 滚动备份压缩方式（由后台维护线程执行）
+enum class BackupCompression {
+    None, // 不压缩
+    Lz4,  // 内置 LZ4 风格块压缩，后缀 .xzlz
+    Gzip, // zlib gzip，后缀 .gz；构建时未找到 zlib 则回退 Lz4
+};
+
+// 时间戳小数精度
+enum class TimePrecision {
+    Milliseconds,
+    Microseconds,
+    Nanoseconds,
+};
+
+// 时间戳时钟源
+enum class ClockSource {
+    System,    // system_clock，精确墙钟
+    Coarse,    // Linux CLOCK_REALTIME_COARSE，读取更廉价，分辨率为毫秒级节拍；其他平台回退 System
+    Monotonic, // 以启动时墙钟为锚点的单调时钟，不受系统校时回拨影响
+};
+
+class LogSink;
+
 // 用户可配置的日志初始化参数
 struct LoggerConfig {
     bool toFile{false};                            // 是否写入文件
@@ -34,21 +83,49 @@ struct LoggerConfig {
     bool asyncLogging{true};                       // 是否启用异步日志
     std::size_t batchSize{8};                      // 批量写入条数阈值
     std::size_t flushIntervalMs{200};              // 批量写入超时时间（毫秒）
+    std::size_t queueCapacity{8192};               // 异步队列容量（条），向上取整为 2 的幂
+    OverflowPolicy overflowPolicy{OverflowPolicy::Block}; // 队列满时的处理策略
+    std::size_t blockTimeoutMs{0};                 // Block 策略的最长等待，超时丢弃本条；0 表示一直等待
+    std::string spillPath;                         // Spill 策略的溢出文件；空时使用自动删除的临时文件
+    std::size_t spillMaxBytes{256 * 1024 * 1024};  // 溢出文件上限，超出后丢弃新记录；0 表示不限
+    FlushPolicy flushPolicy{FlushPolicy::EveryBatch}; // 文件写出策略
+    std::size_t flushBytesThreshold{64 * 1024};    // EveryNBytes 策略的字节阈值
+    std::size_t flushTimeIntervalMs{1000};         // Interval 策略的间隔；其他非逐批策略下空闲时的最长滞留时间
+    bool deferredFormatting{false};                // 异步模式下由后台线程格式化，调用线程仅采集原始字段
+    // 落盘保证
+    Durability durability{Durability::None};       // 落盘模式，见 Durability
+    std::size_t durabilityIntervalMs{1000};        // Interval 模式的落盘间隔
+    LoggerLevel durabilityLevel{LoggerLevel::ERROR}; // OnError 触发落盘 / GroupCommit 等待落盘的最低等级
     // 滚动控制
     bool enableRotation{false};                    // 是否开启日志滚动
     std::size_t maxFileSizeBytes{2 * 1024 * 1024}; // 按大小滚动阈值
     std::size_t maxBackupFiles{3};                 // 备份文件数，超出则覆盖最旧
     std::size_t rotationIntervalSeconds{0};        // 按时间滚动间隔，0 表示关闭
+    BackupCompression backupCompression{BackupCompression::None}; // 备份压缩方式（后台线程执行）
+    std::size_t maxBackupTotalBytes{0};            // 备份总字节上限，超出时从最旧开始删除；0 表示不限
+    std::size_t maxBackupAgeSeconds{0};            // 备份最长保留时间（按修改时间），0 表示不限
+    bool useMmap{false};                           // mmap 写入：按 maxFileSizeBytes 预分配段并直接 memcpy（仅文本格式，POSIX）
     // 格式化选项
     bool includePlatform{true};                    // 是否输出操作系统
     bool includeSource{true};                      // 是否输出源文件/行/函数
-    LogFormat logFormat{LogFormat::HumanFriendly}; // 输出格式：HumanFriendly/Json
+    LogFormat logFormat{LogFormat::HumanFriendly}; // 输出格式：HumanFriendly/Json/Binary
     bool colorConsole{true};                       // 控制台彩色输出（级别染色）
     bool includeMdc{true};                         // 是否输出 MDC 上下文字段
 
     bool writeTime{true};                          // 是否写入时间戳
+    TimePrecision timePrecision{TimePrecision::Milliseconds}; // 时间戳小数精度：毫秒/微秒/纳秒
+    ClockSource clockSource{ClockSource::System};  // 时间戳时钟源
     bool toConsole{true};                          // 是否输出到控制台
+    bool asyncConsole{false};                      // 控制台使用独立写线程，慢终端不拖慢文件写入
+    std::vector<std::shared_ptr<LogSink>> sinks;   // 额外输出目标（与 toConsole/toFile 生成的内置 sink 并存）
     std::vector<LoggerLevel> disableLevels;        // 显式禁止的日志等级
     std::vector<LoggerLevel> onlyLevels;           // 仅允许的日志等级（非空时优先生效）
+    std::string watchConfigFile;                   // 非空时监视该 key=value 文件，热加载等级与格式开关
+    std::size_t flightRecorderSize{0};             // 飞行记录器容量（条）：在内存中留存被等级过滤掉的最近记录，0 关闭
+    LoggerLevel flightRecorderLevel{LoggerLevel::DEBUG};   // 飞行记录器留存的最低等级
+    LoggerLevel flightRecorderTrigger{LoggerLevel::ERROR}; // 不低于该等级的记录写出前，先转储留存的记录
+    bool crashHandler{false};                      // 致命信号（SIGSEGV/SIGABRT 等）时写出尚未落盘的记录，再按原方式终止
+    std::string crashLogPath;                      // 崩溃抢救记录的输出文件；空时不滚动的 Human-Friendly 文本日志追加到主文件，其余写到 <主文件名>.crash.log
+    std::size_t statsIntervalMs{0};                // 周期性写出自身指标（INFO 记录，名称 xzero.stats，消息为 JSON），0 关闭
     bool useErrorCode{true};                       // 是否输出错误码
 };
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Logger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 运行时配置热加载：监视一个 key=value 文本文件，变更后立即调整等级与格式开关，无需重启
+// 文件格式（# 之后为注释，等级名不区分大小写）：
+//   level = INFO              # 根等级：DEBUG / INFO / WARN / ERROR / OFF
+//   level.net.http = DEBUG    # 命名日志器子树的等级（仅作用于 LoggerRegistry）
+//   format.source = false     # time / platform / source / mdc / error_code
+// 目标为 nullptr 时作用于 LoggerRegistry（level 对应根名称 ""），否则作用于指定日志器。
+// Linux 下通过 inotify 监视所在目录（兼容编辑器"写临时文件再 rename"的保存方式），
+// 其他平台按 poll_ms 轮询修改时间与大小。文件中任一行无效时整份配置不生效。
+class LogConfigWatcher {
+public:
+    // 构造时立即应用一次（文件不存在时跳过），随后启动监视线程
+    explicit LogConfigWatcher(const std::string& path, Logger* target = nullptr,
+                              std::size_t poll_ms = 1000);
+    ~LogConfigWatcher();
+
+    LogConfigWatcher(const LogConfigWatcher&) = delete;
+    LogConfigWatcher& operator=(const LogConfigWatcher&) = delete;
+
+    // 立即读取并应用；文件不可读或内容无效时返回 false，当前设置保持不变
+    bool reload();
+    // 成功应用的次数（含构造时的一次）
+    std::size_t reload_count() const { return reload_count_.load(std::memory_order_relaxed); }
+
+    // 解析并应用一段配置文本；error 非空时写入第一处错误
+    static bool apply(const std::string& text, Logger* target, std::string* error = nullptr);
+
+private:
+    void open_inotify();   // 不支持或初始化失败时 inotify_fd_ 保持 -1，改为轮询
+    void run();
+    void watch_inotify();
+    void watch_polling();
+
+    std::string path_;
+    Logger* target_;
+    std::size_t poll_ms_;
+    std::atomic<std::size_t> reload_count_{0};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_{false};
+    int inotify_fd_{-1};
+    int wake_fds_[2]{-1, -1}; // inotify 等待时用于唤醒退出的管道
+    std::thread worker_;
+};
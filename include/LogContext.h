@@ -1,10 +1,31 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 // 线程局部的 MDC（Mapped Diagnostic Context），用于携带 traceId/sessionId 等上下文
+// 存储为按插入顺序排列的扁平数组（通常只有少量键，线性查找比哈希更快），每次修改递增版本号；
+// 记录日志时取当前线程的不可变快照，版本未变时复用缓存的快照及其预渲染片段，只增加一次引用计数。
 namespace XZeroMDC {
+
+using Entry = std::pair<std::string, std::string>;
+
+// 不可变的上下文快照，由记录共享引用
+struct Snapshot {
+    std::vector<Entry> entries; // 按插入顺序
+    std::string human;          // " [CTX:k=v k2=v2]"
+    std::string json;           // ",\"context\":{\"k\":\"v\",...}"（已转义）
+};
+
+using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+// 由键值列表构造快照并渲染片段（解码器、溢出文件回放等使用）；列表为空时返回空指针
+SnapshotPtr make_snapshot(std::vector<Entry> entries);
+
 // 添加/更新键值
 void put(const std::string& key, const std::string& value);
 // 移除键
@@ -15,4 +36,23 @@ void clear();
 std::string get(const std::string& key);
 // 获取当前线程全部上下文（拷贝）
 std::unordered_map<std::string, std::string> all();
+// 当前线程上下文的快照；自上次调用以来未修改时直接返回缓存，无上下文时返回空指针
+SnapshotPtr snapshot();
+
+// 作用域内的上下文键：构造时 put，析构时恢复原值（原先不存在则移除）
+// 新键追加在末尾，按后进先出嵌套使用时析构只需弹出末尾元素
+class Scope {
+public:
+    Scope(const std::string& key, const std::string& value);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    std::string key_;
+    std::string previous_;
+    bool had_previous_{false};
+};
+
 } // namespace XZeroMDC
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "LogRecord.h"
+
+#include <cstddef>
+#include <string>
+
+class LogBackend;
+
+// 崩溃保护：进程因致命信号终止时，抢救各后端中尚未写出的记录
+// - 致命信号（SIGSEGV / SIGBUS / SIGFPE / SIGILL / SIGABRT）：在信号处理函数中只用异步信号安全的操作
+//   （预先打开的 fd + write，不加锁、不分配），依次写出 sink 缓冲、分发线程手中的批次与队列中的记录，
+//   追加一行崩溃标记后恢复原处理方式并重新触发该信号（core dump / 上层处理函数照常工作）；
+// - 正常 exit() 与 quick_exit()：等待各后端队列写空并写出 sink 缓冲。
+// 后端在 cfg.crashHandler 为 true 时自动登记并调用 install()。
+namespace XZeroCrash {
+
+// 安装信号处理与退出钩子；可重复调用，只安装一次
+void install();
+
+// 后端登记（最多 64 个，超出的后端不受保护）
+void register_backend(LogBackend* backend);
+void unregister_backend(LogBackend* backend);
+
+// 以下函数异步信号安全，供信号处理函数使用
+void write_all(int fd, const char* data, std::size_t n);
+void write_str(int fd, const char* s);
+void write_uint(int fd, unsigned long long value);
+// 无预渲染文本时的最小渲染：[UTC 时间] [等级] [TID:..] [名称] (file:line func) - message (Error Code: n)
+void write_record(int fd, const LogRecord& rec);
+
+} // namespace XZeroCrash
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+
+// 结构化字段：键 + 带类型标签的值（整数 / 无符号整数 / 浮点 / 布尔 / 字符串）
+// 只引用调用方的键与字符串，不分配内存；用于 {{"status", 200}, {"ok", true}} 形式的初始化列表，
+// 仅在调用期间有效，采集时编码进记录（见 XZeroFields::encode）。
+class LogField {
+public:
+    enum class Type : unsigned char {
+        Int,
+        UInt,
+        Double,
+        Bool,
+        String,
+    };
+
+    LogField(const char* key, int v) : LogField(key, Type::Int) { value_.i = v; }
+    LogField(const char* key, long v) : LogField(key, Type::Int) { value_.i = v; }
+    LogField(const char* key, long long v) : LogField(key, Type::Int) { value_.i = v; }
+    LogField(const char* key, unsigned v) : LogField(key, Type::UInt) { value_.u = v; }
+    LogField(const char* key, unsigned long v) : LogField(key, Type::UInt) { value_.u = v; }
+    LogField(const char* key, unsigned long long v) : LogField(key, Type::UInt) { value_.u = v; }
+    LogField(const char* key, double v) : LogField(key, Type::Double) { value_.d = v; }
+    LogField(const char* key, float v) : LogField(key, Type::Double) { value_.d = v; }
+    LogField(const char* key, bool v) : LogField(key, Type::Bool) { value_.b = v; }
+    LogField(const char* key, const char* v) : LogField(key, Type::String) {
+        value_.s.data = v ? v : "";
+        value_.s.size = v ? std::strlen(v) : 0;
+    }
+    LogField(const char* key, const std::string& v) : LogField(key, Type::String) {
+        value_.s.data = v.data();
+        value_.s.size = v.size();
+    }
+    // 解码时使用：键与字符串值均以指针 + 长度引用编码缓冲
+    LogField(const char* key, std::size_t key_size, Type type)
+        : key_(key), key_size_(key_size), type_(type) {}
+
+    const char* key() const { return key_; }
+    std::size_t key_size() const { return key_size_; }
+    Type type() const { return type_; }
+
+    long long as_int() const { return value_.i; }
+    unsigned long long as_uint() const { return value_.u; }
+    double as_double() const { return value_.d; }
+    bool as_bool() const { return value_.b; }
+    const char* str_data() const { return value_.s.data; }
+    std::size_t str_size() const { return value_.s.size; }
+
+    void set_int(long long v) { value_.i = v; }
+    void set_uint(unsigned long long v) { value_.u = v; }
+    void set_double(double v) { value_.d = v; }
+    void set_bool(bool v) { value_.b = v; }
+    void set_str(const char* data, std::size_t size) {
+        value_.s.data = data;
+        value_.s.size = size;
+    }
+
+private:
+    LogField(const char* key, Type type)
+        : key_(key ? key : ""), key_size_(key ? std::strlen(key) : 0), type_(type) {}
+
+    const char* key_;
+    std::size_t key_size_;
+    Type type_;
+    union {
+        long long i;
+        unsigned long long u;
+        double d;
+        bool b;
+        struct {
+            const char* data;
+            std::size_t size;
+        } s;
+    } value_;
+};
+
+// 字段在记录中的紧凑编码：所有字段连续写入一个缓冲，空表示无字段（普通日志零开销）
+// 每个字段: u8 类型 | varint 键长 + 键 | 值
+//   Int: zigzag varint；UInt: varint；Double: 8 字节小端 IEEE 754；Bool: u8；String: varint 长度 + 字节
+// 与平台字节序无关，二进制日志文件直接内嵌该编码。
+namespace XZeroFields {
+
+void encode(const LogField* fields, std::size_t n, std::string& out);
+
+inline void encode(std::initializer_list<LogField> fields, std::string& out) {
+    encode(fields.begin(), fields.size(), out);
+}
+
+// 逐个解码并回调 f(const LogField&)；键与字符串值引用 encoded 的内存。编码损坏时返回 false
+template <typename F>
+bool for_each(const std::string& encoded, F f);
+
+// " status=200 latency_us=1234.5 ok=true user=alice"
+// 字符串值含空白、'='、'"' 或控制字符（或为空）时加双引号并转义 '"'、'\' 与控制字符，如 note="a b"；换行不会拆成新的日志行
+void append_human(std::string& out, const std::string& encoded);
+// ",\"fields\":{\"status\":200,\"latency_us\":1234.5,\"ok\":true}"（数字与布尔为原生 JSON 值，字符串转义）
+void append_json(std::string& out, const std::string& encoded);
+
+namespace detail {
+
+struct Cursor {
+    const unsigned char* p;
+    const unsigned char* end;
+    bool ok;
+
+    std::uint64_t varint() {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7) {
+            const unsigned char b = *p++;
+            v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return v;
+        }
+        ok = false;
+        return 0;
+    }
+
+    const char* bytes(std::size_t n) {
+        if (static_cast<std::size_t>(end - p) < n) {
+            ok = false;
+            return nullptr;
+        }
+        const char* s = reinterpret_cast<const char*>(p);
+        p += n;
+        return s;
+    }
+};
+
+} // namespace detail
+
+template <typename F>
+bool for_each(const std::string& encoded, F f) {
+    detail::Cursor c{reinterpret_cast<const unsigned char*>(encoded.data()),
+                     reinterpret_cast<const unsigned char*>(encoded.data()) + encoded.size(), true};
+    while (c.ok && c.p < c.end) {
+        const LogField::Type type = static_cast<LogField::Type>(*c.p++);
+        const std::size_t key_size = static_cast<std::size_t>(c.varint());
+        const char* key = c.ok ? c.bytes(key_size) : nullptr;
+        if (!c.ok) break;
+        LogField field(key, key_size, type);
+        switch (type) {
+        case LogField::Type::Int: {
+            const std::uint64_t v = c.varint();
+            field.set_int(static_cast<long long>(v >> 1) ^ -static_cast<long long>(v & 1));
+            break;
+        }
+        case LogField::Type::UInt:
+            field.set_uint(c.varint());
+            break;
+        case LogField::Type::Double: {
+            const char* raw = c.bytes(8);
+            if (!raw) break;
+            std::uint64_t bits = 0;
+            for (int i = 7; i >= 0; --i) {
+                bits = (bits << 8) | static_cast<unsigned char>(raw[i]);
+            }
+            double d;
+            std::memcpy(&d, &bits, sizeof(d));
+            field.set_double(d);
+            break;
+        }
+        case LogField::Type::Bool: {
+            const char* raw = c.bytes(1);
+            if (raw) field.set_bool(*raw != 0);
+            break;
+        }
+        case LogField::Type::String: {
+            const std::size_t n = static_cast<std::size_t>(c.varint());
+            const char* data = c.ok ? c.bytes(n) : nullptr;
+            if (data) field.set_str(data, n);
+            break;
+        }
+        default:
+            c.ok = false;
+            break;
+        }
+        if (!c.ok) break;
+        f(static_cast<const LogField&>(field));
+    }
+    return c.ok;
+}
+
+} // namespace XZeroFields
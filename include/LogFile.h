@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 基于原始文件描述符的日志文件，两种模式：
+// 1) writev 模式（open）
+//    - add_ref：登记调用方内存（零拷贝），须保证在 flush/end_batch 之前有效
+//    - add_copy：拷贝到内部缓冲，适用于临时数据
+//    - flush：将全部待写数据聚合为 iovec，一次 writev 提交（超出 IOV_MAX 时分段）
+// 2) mmap 模式（open_mapped，仅 POSIX）
+//    - 按段预分配（posix_fallocate）并映射，写入即 memcpy，无 write 系统调用
+//    - 空间不足时按段扩展；close 时截断到实际长度
+//    - 打开已有文件时去掉崩溃遗留的尾部 0 填充（要求记录本身不以 0 字节结尾，文本行满足）
+class LogFile {
+public:
+    LogFile() = default;
+    ~LogFile();
+
+    LogFile(const LogFile&) = delete;
+    LogFile& operator=(const LogFile&) = delete;
+
+    bool open(const std::string& path, bool truncate);
+    // 以 mmap 模式打开，segment_bytes 为预分配/扩展粒度；平台不支持时退回 writev 模式
+    bool open_mapped(const std::string& path, bool truncate, std::size_t segment_bytes);
+    void close();             // flush 后关闭
+    bool is_open() const { return fd_ >= 0; }
+    int fd() const { return fd_; }
+
+    void add_ref(const char* data, std::size_t n);
+    void add_copy(const char* data, std::size_t n);
+
+    // 批次结束：flush_now 为 true 时立即写出；否则把引用的外部内存转存到内部缓冲
+    bool end_batch(bool flush_now);
+    bool flush();
+    // 把已写出的数据落盘：writev 模式 fdatasync，mmap 模式 msync；不含待写缓冲，须先 flush
+    bool sync();
+    // 异步信号安全：直接 write 出待写数据，不修改内部状态（仅供崩溃处理）
+    void emergency_flush() const;
+
+    std::size_t pending_bytes() const { return pending_bytes_; }
+    // 逻辑长度：打开时的文件长度 + 已写出 + 待写出
+    std::size_t logical_size() const { return base_size_ + pending_bytes_; }
+    bool is_mapped() const { return mapped_; }
+
+private:
+    struct Slice {
+        const char* data;
+        std::size_t len;
+    };
+
+    void materialize(); // 外部引用转为内部拷贝，保持写入顺序
+    bool write_all(std::vector<Slice>& slices);
+    bool map_append(const char* data, std::size_t n);
+    bool map_reserve(std::size_t required);
+    void map_release();
+
+    int fd_{-1};
+    std::size_t base_size_{0}; // 已落到文件中的字节数（mmap 模式下即映射内的有效长度）
+    bool mapped_{false};       // mmap 模式（映射失败后仍保持该模式，只记录错误）
+    bool map_failed_{false};   // 自上次 flush 以来是否有写入失败
+    char* map_{nullptr};
+    std::size_t map_capacity_{0};
+    std::size_t segment_bytes_{0};
+    std::string buffer_;       // 内部拷贝的数据（总在 refs_ 之前写出）
+    std::vector<Slice> refs_;  // 外部内存引用
+    std::size_t pending_bytes_{0};
+};
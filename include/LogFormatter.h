@@ -0,0 +1,43 @@
+#pragma once
+
+#include "LogConfig.h"
+#include "LogRecord.h"
+
+#include <atomic>
+#include <string>
+
+// 将 LogRecord 渲染为单行文本（HumanFriendly / Json）
+// 字段开关保存在原子位掩码中，可在运行时调整；每次渲染读取一次，可在多线程并发使用
+class LogFormatter {
+public:
+    // 可运行时开关的字段，初值取自 writeTime / includePlatform / includeSource / includeMdc / useErrorCode
+    enum FormatFlag : unsigned {
+        kFormatTime = 1u << 0,
+        kFormatPlatform = 1u << 1,
+        kFormatSource = 1u << 2,
+        kFormatMdc = 1u << 3,
+        kFormatErrorCode = 1u << 4,
+    };
+
+    LogFormatter(const LoggerConfig& cfg, const std::string& platform);
+
+    LogFormatter(const LogFormatter&) = delete;
+    LogFormatter& operator=(const LogFormatter&) = delete;
+
+    unsigned flags() const { return flags_.load(std::memory_order_relaxed); }
+    void set_flag(FormatFlag flag, bool enabled);
+
+    std::string format(const LogRecord& rec) const;
+    // 按指定格式渲染（Binary 无文本形式，按 HumanFriendly 处理）
+    std::string format(const LogRecord& rec, LogFormat format) const;
+
+private:
+    std::string format_json(const LogRecord& rec, unsigned flags) const;
+    std::string format_human(const LogRecord& rec, unsigned flags) const;
+    // 追加 "file.cpp:120 func"；json 为 true 时追加转义后的形式
+    void append_source(std::string& out, const LogRecord& rec, bool json) const;
+
+    LoggerConfig config_;
+    std::string platform_;
+    std::atomic<unsigned> flags_;
+};
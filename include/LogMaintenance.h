@@ -0,0 +1,52 @@
+#pragma once
+
+#include "LogConfig.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 滚动备份的后台维护线程
+// 写线程滚动时只把主文件 rename 为暂存名并提交，其余工作全部在这里完成：
+//   1) 备份依次后移：log.1 -> log.2 ...（超出 maxBackupFiles 的最旧备份删除）
+//   2) 暂存文件压缩（或直接改名）为 log.1[.xzlz|.gz]
+//   3) 按 maxBackupTotalBytes / maxBackupAgeSeconds 从最旧开始清理
+// 任务按提交顺序串行执行，析构时处理完剩余任务再退出。
+// 启动时的首个任务先按上述流程补做上次运行遗留的暂存文件，再执行一次清理。
+class LogMaintenance {
+public:
+    explicit LogMaintenance(const LoggerConfig& cfg);
+    ~LogMaintenance();
+
+    LogMaintenance(const LogMaintenance&) = delete;
+    LogMaintenance& operator=(const LogMaintenance&) = delete;
+
+    // 生成唯一暂存名（与编号备份不冲突）
+    std::string staging_path();
+    // 提交已关闭的暂存文件；不阻塞
+    void submit(const std::string& staged);
+    // 等待已提交任务全部完成（测试/演示用）
+    void wait_idle();
+
+private:
+    void run();
+    void process(const std::string& staged); // staged 为空表示启动任务
+    void recover_staged();
+    void shift_backups();
+    void enforce_retention();
+    std::string backup_path(std::size_t index, const char* ext) const;
+
+    LoggerConfig config_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable idle_cv_;
+    std::deque<std::string> jobs_;
+    bool busy_{false};
+    std::size_t seq_{0}; // 暂存名序号（调用方在 io 锁内生成）
+    bool stop_{false};
+    unsigned long long started_ns_; // 创建时刻；早于此的暂存名视为上次运行的遗留
+    std::thread worker_;
+};
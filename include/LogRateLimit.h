@@ -0,0 +1,261 @@
+#pragma once
+
+#include "Logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <string>
+
+// 调用点级别的限流、采样与重复折叠
+// 每个宏展开处持有一个函数内静态状态对象（按 __FILE__/__LINE__ 天然区分），
+// 检查在调用线程上完成、位于消息求值与格式化之前；被拦下的记录不入队、不格式化、不写出。
+// 被抑制的条数以一条汇总记录补报，不会悄悄丢失：调用点再次放行时先行补报；
+// 此外调用点首次开始抑制时向日志器登记（Logger::defer_suppressed），FileLogger 的后端按约每秒一次
+// 以及析构时补报尚未报告的条数，风暴结束后不再放行的调用点同样会被报告。
+namespace XZeroRate {
+
+inline std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 待补报的抑制计数：调用线程累加，放行时由宏或由后端定时取出
+// 有意保持平凡析构：函数内静态对象不登记析构，进程退出阶段后端仍可安全读取
+class Suppression {
+public:
+    // summary 为 "{}" 占位的汇总消息，须为字符串字面量
+    explicit Suppression(const char* summary) : summary_(summary) {}
+
+    Suppression(const Suppression&) = delete;
+    Suppression& operator=(const Suppression&) = delete;
+
+    // 取出并清零尚未补报的条数；先解除登记标记，之后的抑制会重新登记
+    std::uint64_t take() {
+        armed_.store(false, std::memory_order_relaxed);
+        if (count_.load(std::memory_order_relaxed) == 0) return 0;
+        return count_.exchange(0, std::memory_order_relaxed);
+    }
+
+    // 抑制发生后调用：返回 true 表示本次须向日志器登记（此前未登记或已被取走）
+    bool arm() {
+        return !armed_.load(std::memory_order_relaxed) &&
+               !armed_.exchange(true, std::memory_order_relaxed);
+    }
+
+    const char* summary() const { return summary_; }
+
+protected:
+    void add() { count_.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    const char* const summary_;
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<bool> armed_{false};
+};
+
+// 令牌桶（GCRA 形式）：状态只有一个"理论到达时间" tat，放行 = 一次 load + 一次 CAS
+// 平均每秒放行 per_second 条，允许一次突发 burst 条
+class RateLimiter : public Suppression {
+public:
+    RateLimiter(double per_second, unsigned burst)
+        : Suppression("限流：该调用点抑制了 {} 条日志"),
+          interval_ns_(per_second > 0 ? static_cast<std::int64_t>(1e9 / per_second) : 0),
+          limit_ns_(interval_ns_ * static_cast<std::int64_t>(burst == 0 ? 1 : burst)) {}
+
+    bool allow() {
+        if (interval_ns_ <= 0) {
+            // per_second <= 0 视为关闭该调用点
+            add();
+            return false;
+        }
+        const std::int64_t now = now_ns();
+        std::int64_t tat = tat_.load(std::memory_order_relaxed);
+        for (;;) {
+            const std::int64_t next = (tat > now ? tat : now) + interval_ns_;
+            if (next - now > limit_ns_) {
+                add();
+                return false;
+            }
+            if (tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    // 取出并清零此前被拦下的条数（放行后调用，用于补报）
+    std::uint64_t take_suppressed() { return take(); }
+
+private:
+    const std::int64_t interval_ns_;
+    const std::int64_t limit_ns_;
+    std::atomic<std::int64_t> tat_{0};
+};
+
+// 1/N 采样：每 N 次放行第 1 次，只有一次 fetch_add；放行的记录代表 N 条，不再单独补报
+class Sampler {
+public:
+    explicit Sampler(std::uint64_t every) : every_(every == 0 ? 1 : every) {}
+
+    Sampler(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+
+    bool allow() { return count_.fetch_add(1, std::memory_order_relaxed) % every_ == 0; }
+
+private:
+    const std::uint64_t every_;
+    std::atomic<std::uint64_t> count_{0};
+};
+
+// 重复折叠：同一调用点连续产生相同消息时只输出第一条，
+// 消息变化时（或重复持续超过 window_ms）补报 "上条消息重复 N 次"
+// 需要先求值消息以比较哈希，但仍在入队与格式化之前
+class Deduper : public Suppression {
+public:
+    explicit Deduper(std::uint64_t window_ms = 30000)
+        : Suppression("上条消息重复 {} 次"),
+          window_ns_(static_cast<std::int64_t>(window_ms) * 1000000) {}
+
+    // 返回 true 表示输出本条；repeated 为需要先行补报的重复条数（0 表示无需补报）
+    bool admit(const std::string& message, std::uint64_t& repeated) {
+        // 哈希 0 留作"尚无消息"
+        const std::size_t hash = std::hash<std::string>()(message) | 1u;
+        const std::size_t prev = last_hash_.exchange(hash, std::memory_order_relaxed);
+        const std::int64_t now = now_ns();
+        if (prev != hash) {
+            repeated = take();
+            window_start_.store(now, std::memory_order_relaxed);
+            return true;
+        }
+        add();
+        repeated = 0;
+        // 长时间持续重复：窗口到期时补报一次，避免汇总一直拖到消息变化
+        std::int64_t start = window_start_.load(std::memory_order_relaxed);
+        if (now - start >= window_ns_ &&
+            window_start_.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+            repeated = take();
+        }
+        return false;
+    }
+
+private:
+    const std::int64_t window_ns_;
+    std::atomic<std::size_t> last_hash_{0};
+    std::atomic<std::int64_t> window_start_{0};
+};
+
+static_assert(std::is_trivially_destructible<RateLimiter>::value &&
+                  std::is_trivially_destructible<Deduper>::value,
+              "调用点状态须平凡析构，后端在进程退出阶段仍会读取");
+
+// 汇总记录：沿用原调用点的等级与源信息；LoggerPtr 可为裸指针或智能指针
+template <typename LoggerPtr>
+void report_suppressed(const LoggerPtr& logger, LoggerLevel level, std::uint64_t count,
+                       const LogSite& site) {
+    logger->logf_at(site, level, 0, "限流：该调用点抑制了 {} 条日志", count);
+}
+
+template <typename LoggerPtr>
+void report_repeated(const LoggerPtr& logger, LoggerLevel level, std::uint64_t count,
+                     const LogSite& site) {
+    logger->logf_at(site, level, 0, "上条消息重复 {} 次", count);
+}
+
+} // namespace XZeroRate
+
+// 令牌桶限流：平均每秒最多 perSecond 条、突发 burst 条；被拦下的条数在下次放行前（或由后端定时）补报
+//   XZERO_LOG_RATE(logger, LoggerLevel::ERROR, 10, 20, "下游不可用", err);
+// perSecond / burst 仅在该调用点首次执行时读取
+#define XZERO_LOG_RATE(logger, level, perSecond, burst, message, errorCode)         \
+    do {                                                                            \
+        const LoggerLevel xzero_level_ = (level);                                   \
+        if (Logger::severity(xzero_level_) >= XZERO_MIN_LEVEL &&                    \
+            (logger)->should_log(xzero_level_)) {                                   \
+            static XZeroRate::RateLimiter xzero_limiter_((perSecond), (burst));     \
+            XZERO_SITE(xzero_site_);                                                \
+            if (xzero_limiter_.allow()) {                                           \
+                const std::uint64_t xzero_dropped_ = xzero_limiter_.take_suppressed(); \
+                if (xzero_dropped_ != 0) {                                          \
+                    XZeroRate::report_suppressed((logger), xzero_level_, xzero_dropped_, \
+                                                 xzero_site_);                      \
+                }                                                                   \
+                (logger)->log_at(xzero_site_, xzero_level_, (message), (errorCode)); \
+            } else if (xzero_limiter_.arm()) {                                      \
+                (logger)->defer_suppressed(xzero_limiter_, xzero_site_, xzero_level_); \
+            }                                                                       \
+        }                                                                           \
+    } while (0)
+
+// 1/N 采样：每 n 次执行输出一次
+#define XZERO_LOG_EVERY_N(logger, level, n, message, errorCode)                     \
+    do {                                                                            \
+        const LoggerLevel xzero_level_ = (level);                                   \
+        if (Logger::severity(xzero_level_) >= XZERO_MIN_LEVEL &&                    \
+            (logger)->should_log(xzero_level_)) {                                   \
+            static XZeroRate::Sampler xzero_sampler_((n));                          \
+            XZERO_SITE(xzero_site_);                                                \
+            if (xzero_sampler_.allow()) {                                           \
+                (logger)->log_at(xzero_site_, xzero_level_, (message), (errorCode)); \
+            }                                                                       \
+        }                                                                           \
+    } while (0)
+
+// 重复折叠：连续相同的消息只输出一次，变化时补报重复次数
+#define XZERO_LOG_DEDUP(logger, level, message, errorCode)                          \
+    do {                                                                            \
+        const LoggerLevel xzero_level_ = (level);                                   \
+        if (Logger::severity(xzero_level_) >= XZERO_MIN_LEVEL &&                    \
+            (logger)->should_log(xzero_level_)) {                                   \
+            static XZeroRate::Deduper xzero_dedup_;                                 \
+            XZERO_SITE(xzero_site_);                                                \
+            const std::string xzero_msg_ = (message);                               \
+            std::uint64_t xzero_repeated_ = 0;                                      \
+            const bool xzero_emit_ = xzero_dedup_.admit(xzero_msg_, xzero_repeated_); \
+            if (xzero_repeated_ != 0) {                                             \
+                XZeroRate::report_repeated((logger), xzero_level_, xzero_repeated_, \
+                                           xzero_site_);                            \
+            }                                                                       \
+            if (xzero_emit_) {                                                      \
+                (logger)->log_at(xzero_site_, xzero_level_, xzero_msg_, (errorCode)); \
+            } else if (xzero_dedup_.arm()) {                                        \
+                (logger)->defer_suppressed(xzero_dedup_, xzero_site_, xzero_level_); \
+            }                                                                       \
+        }                                                                           \
+    } while (0)
+
+// "{}" 占位符版本：限流 / 采样在参数求值与格式化之前完成
+#define XZERO_LOGF_RATE(logger, level, perSecond, burst, errorCode, ...)            \
+    do {                                                                            \
+        const LoggerLevel xzero_level_ = (level);                                   \
+        if (Logger::severity(xzero_level_) >= XZERO_MIN_LEVEL &&                    \
+            (logger)->should_log(xzero_level_)) {                                   \
+            static XZeroRate::RateLimiter xzero_limiter_((perSecond), (burst));     \
+            XZERO_SITE(xzero_site_);                                                \
+            if (xzero_limiter_.allow()) {                                           \
+                const std::uint64_t xzero_dropped_ = xzero_limiter_.take_suppressed(); \
+                if (xzero_dropped_ != 0) {                                          \
+                    XZeroRate::report_suppressed((logger), xzero_level_, xzero_dropped_, \
+                                                 xzero_site_);                      \
+                }                                                                   \
+                (logger)->logf_at(xzero_site_, xzero_level_, (errorCode), __VA_ARGS__); \
+            } else if (xzero_limiter_.arm()) {                                      \
+                (logger)->defer_suppressed(xzero_limiter_, xzero_site_, xzero_level_); \
+            }                                                                       \
+        }                                                                           \
+    } while (0)
+
+#define XZERO_LOGF_EVERY_N(logger, level, n, errorCode, ...)                        \
+    do {                                                                            \
+        const LoggerLevel xzero_level_ = (level);                                   \
+        if (Logger::severity(xzero_level_) >= XZERO_MIN_LEVEL &&                    \
+            (logger)->should_log(xzero_level_)) {                                   \
+            static XZeroRate::Sampler xzero_sampler_((n));                          \
+            XZERO_SITE(xzero_site_);                                                \
+            if (xzero_sampler_.allow()) {                                           \
+                (logger)->logf_at(xzero_site_, xzero_level_, (errorCode), __VA_ARGS__); \
+            }                                                                       \
+        }                                                                           \
+    } while (0)
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "LogConfig.h"
+#include "LogContext.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace XZeroThread {
+struct Tag;
+}
+struct LogSite;
+
+// 一条日志的原始数据：调用线程只负责采集，格式化可延迟到后台线程
+struct LogRecord {
+    LoggerLevel level{LoggerLevel::INFO};
+    std::chrono::system_clock::time_point timestamp; // 采集时刻
+    std::uint64_t threadId{0};                       // 操作系统线程号
+    const XZeroThread::Tag* thread{nullptr};         // 预渲染的线程标签（常驻登记表，无需拷贝）；为空时按 threadId 渲染
+    const char* file{nullptr};                       // 源信息指针（指向静态字符串，无需拷贝）
+    int line{0};
+    const char* func{nullptr};
+    const LogSite* site{nullptr};                    // 调用点描述符（经宏记录时非空，常驻）；file/line/func 与其一致
+    std::string message;
+    int errorCode{0};
+    std::string logger;                               // 命名日志器名称，空表示匿名
+    std::string fields;                               // 结构化字段（XZeroFields 编码），空表示无
+    XZeroMDC::SnapshotPtr mdc;                        // MDC 快照（线程间共享的不可变对象），无上下文时为空
+};
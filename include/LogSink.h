@@ -0,0 +1,98 @@
+#pragma once
+
+#include "LogConfig.h"
+#include "LogRecord.h"
+#include "LogStats.h"
+#include "MpscQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 分发给 sink 的一条日志：原始字段 + 按需渲染的文本
+// 每种格式每条记录只渲染一次，所有使用该格式的 sink 共享同一份文本
+struct LogEntry {
+    LogRecord record;
+    std::string human; // HumanFriendly 文本（有 sink 需要时才填充）
+    std::string json;  // Json 文本（有 sink 需要时才填充）
+
+    const std::string& text(LogFormat format) const {
+        return format == LogFormat::Json ? json : human;
+    }
+};
+
+// 输出目标接口：自带等级过滤与输出格式，内部自行保证线程安全
+// 分发方对每批记录依次调用 write()，随后调用一次 flush()；
+// write() 收到的 entry 在随后的 flush() 返回前保持有效，实现可据此零拷贝引用文本。
+class LogSink {
+public:
+    explicit LogSink(LogFormat format) : format_(format) {}
+    virtual ~LogSink() = default;
+
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    // 输出格式：Binary 的 sink 只使用 entry.record，自行编码
+    LogFormat format() const { return format_; }
+
+    // 等级过滤：低于 level 的记录不会交给该 sink（运行时可调整）
+    void set_level(LoggerLevel level);
+    bool accepts(LoggerLevel level) const;
+
+    virtual void write(const LogEntry& entry) = 0;
+    // 批次结束
+    virtual void flush() {}
+    // 分发线程空闲时调用，用于兜底刷新缓冲
+    virtual void on_idle() {}
+    // 立即写出全部缓冲（不受 flushPolicy 限制），进程退出钩子使用
+    virtual void flush_pending() {}
+    // 写出全部缓冲并落盘（fdatasync），后端按 cfg.durability 调用；无持久化概念的 sink 忽略
+    virtual void sync() {}
+    // 致命信号处理函数中调用：只能使用异步信号安全操作（不加锁、不分配），尽力写出缓冲
+    virtual void emergency_flush() {}
+    // 把自身的写出统计累加到快照（字节数、写出 / fsync 耗时、滚动次数等），可在任意线程调用
+    virtual void collect_stats(LogStatsSnapshot& out) const { (void)out; }
+
+    // 拥有独立写线程的 sink 返回 true，分发方改用 post() 移交共享所有权
+    virtual bool owns_thread() const { return false; }
+    virtual void post(const std::shared_ptr<const LogEntry>& entry) { write(*entry); }
+
+private:
+    LogFormat format_;
+    std::atomic<int> min_severity_{0};
+};
+
+// 独立写线程包装：将任意 sink 放到自己的无锁队列与后台线程上
+// 慢速目标（如终端）只拖慢自己的线程，不影响其他 sink 与日志器的分发线程
+class AsyncSink : public LogSink {
+public:
+    // capacity 为队列容量（条）；idle_ms 为空闲时调用内部 sink on_idle() 的周期
+    explicit AsyncSink(std::shared_ptr<LogSink> inner, std::size_t capacity = 8192,
+                       std::size_t idle_ms = 200);
+    ~AsyncSink();
+
+    void write(const LogEntry& entry) override; // 拷贝一份后入队
+    bool owns_thread() const override { return true; }
+    void post(const std::shared_ptr<const LogEntry>& entry) override;
+    void collect_stats(LogStatsSnapshot& out) const override { inner_->collect_stats(out); }
+
+    const std::shared_ptr<LogSink>& inner() const { return inner_; }
+
+private:
+    void worker_loop();
+    void wake_worker();
+
+    std::shared_ptr<LogSink> inner_;
+    MpscQueue<std::shared_ptr<const LogEntry>> queue_;
+    std::chrono::milliseconds idle_wait_;
+    std::mutex wake_mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> sleeping_{false};
+    std::atomic<bool> stop_{false};
+    std::thread worker_;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+
+// 调用点描述符：每个日志宏展开处一个函数内静态对象，首次执行时构造，之后只传递指针
+// 文件名部分在编译期求得，源信息片段 "file.cpp:120 func" 预先渲染（JSON 版本已转义），
+// 格式化时直接拷贝，不再逐条 strrchr 与拼接；描述符常驻不释放，异步写出的记录可安全引用。
+struct LogSite {
+    const char* file;        // __FILE__
+    const char* base;        // 文件名部分（去掉目录）
+    int line;
+    const char* func;
+    std::string source;      // "file.cpp:120 func"
+    std::string source_json; // source 的 JSON 转义形式（不含引号）
+};
+
+namespace XZeroSite {
+
+namespace detail {
+constexpr const char* basename_from(const char* p, const char* last) {
+    return *p == '\0' ? last
+                      : basename_from(p + 1, (*p == '/' || *p == '\\') ? p + 1 : last);
+}
+} // namespace detail
+
+// 路径中最后一个 '/' 或 '\\' 之后的部分；常量参数可在编译期求值
+constexpr const char* basename(const char* path) {
+    return detail::basename_from(path, path);
+}
+
+// 构造并渲染常驻的描述符（有意不释放），由 XZERO_SITE 在每个调用点调用一次
+const LogSite& make(const char* file, const char* base, int line, const char* func);
+
+} // namespace XZeroSite
+
+// 在当前作用域声明调用点描述符 name（函数内静态，首次执行时初始化）
+#define XZERO_SITE(name)                                                   \
+    static const LogSite& name =                                           \
+        XZeroSite::make(__FILE__, XZeroSite::basename(__FILE__), __LINE__, __func__)
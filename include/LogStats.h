@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// HDR 风格直方图：对数-线性分桶，每个 2 的幂区间 8 个子桶（相对误差不超过 12.5%），0..15 精确计数
+// 全部为原子计数，记录只需几次 relaxed 原子操作，可多线程并发记录与读取
+class LogHistogram {
+public:
+    static const std::size_t kSubBuckets = 8;
+    static const std::size_t kBuckets = 62 * kSubBuckets;
+
+    struct Snapshot {
+        std::uint64_t count{0};
+        std::uint64_t sum{0};
+        std::uint64_t max{0};
+        std::vector<std::uint64_t> buckets; // 空表示无数据
+
+        // 分位数（q 取 0..1），返回所在桶的上界（不超过 max）
+        std::uint64_t percentile(double q) const;
+        double mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+        void merge(const Snapshot& other);
+        // {"count":..,"mean":..,"p50":..,"p90":..,"p99":..,"p999":..,"max":..}
+        std::string to_json() const;
+    };
+
+    LogHistogram();
+
+    LogHistogram(const LogHistogram&) = delete;
+    LogHistogram& operator=(const LogHistogram&) = delete;
+
+    void record(std::uint64_t value);
+    Snapshot snapshot() const;
+
+    static std::size_t bucket_index(std::uint64_t value);
+    static std::uint64_t bucket_upper(std::size_t index);
+
+private:
+    std::atomic<std::uint64_t> buckets_[kBuckets];
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+// 日志器自身指标快照（stats() 返回），各字段均为自后端创建以来的累计值
+struct LogStatsSnapshot {
+    std::uint64_t enqueued{0};         // 提交到后端的记录（异步模式为入队数）
+    std::uint64_t written{0};          // 已分发到 sink 的记录
+    std::uint64_t dropped{0};          // 因背压策略丢弃的记录
+    std::uint64_t spilled{0};          // 写入溢出文件（稍后回放）的记录
+    std::uint64_t filtered{0};         // 到达日志器后被等级过滤（含仅进入飞行记录器）的记录；宏的预检不计入
+    std::uint64_t queue_depth{0};      // 当前队列深度（近似）
+    std::uint64_t queue_high_water{0}; // 分发线程观察到的最大队列深度
+    std::uint64_t queue_capacity{0};
+    std::uint64_t queue_full_waits{0}; // 生产者遇到队列满而等待的次数
+    std::uint64_t rotations{0};        // 文件滚动次数
+    std::uint64_t bytes_written{0};    // 交给文件 sink 的字节数
+    LogHistogram::Snapshot batch_size;       // 每批记录数
+    LogHistogram::Snapshot batch_latency_ns; // 每批渲染 + 分发耗时
+    LogHistogram::Snapshot write_latency_ns; // 文件 sink 每次写出（writev）耗时
+    LogHistogram::Snapshot fsync_latency_ns; // 文件 sink 每次 fsync 耗时
+
+    std::string to_json() const;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// 线程标识：每个线程首次记录日志时取一次操作系统线程号（Linux gettid / macOS pthread_threadid_np /
+// Windows GetCurrentThreadId），连同可选的线程名预先渲染成两种格式的片段，缓存在 thread_local 指针中。
+// 片段登记在进程级表中常驻不释放（按 线程号 + 名称 去重），记录只保存指针，
+// 线程退出后异步写出的记录仍可安全引用。
+namespace XZeroThread {
+
+struct Tag {
+    std::uint64_t id{0}; // 操作系统线程号
+    std::string name;    // 线程名，未设置时为空
+    std::string human;   // "TID:12345" 或 "TID:12345 io-worker"
+    std::string json;    // "\"thread\":\"TID:12345\"" [+ ",\"thread_name\":\"io-worker\""]
+};
+
+namespace detail {
+extern thread_local const Tag* tl_tag;
+const Tag& register_current();
+} // namespace detail
+
+// 当前线程的标签；首次调用后只需一次 thread_local 读取
+inline const Tag& current() {
+    const Tag* tag = detail::tl_tag;
+    return tag ? *tag : detail::register_current();
+}
+
+inline std::uint64_t current_id() { return current().id; }
+
+// 设置当前线程的名称（空串表示清除），之后的记录携带新的标签
+void set_name(const std::string& name);
+
+} // namespace XZeroThread
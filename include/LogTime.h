@@ -0,0 +1,39 @@
+#pragma once
+
+#include "LogConfig.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// 时间戳引擎：按线程缓存秒级前缀 "YYYY-mm-dd HH:MM:SS"，同一秒内只改写小数部分，
+// 避免每条日志都调用 localtime_r/gmtime_r 与 ostringstream
+namespace XZeroTime {
+
+// 格式化结果的最大长度（含纳秒与时区后缀），调用方可据此准备栈上缓冲
+const std::size_t kMaxTimestampLen = 40;
+
+// 按时钟源读取当前时刻
+std::chrono::system_clock::time_point now(ClockSource source);
+
+// 本地时间 "YYYY-mm-dd HH:MM:SS.fff"，写入 out 并返回长度
+std::size_t format_local(const std::chrono::system_clock::time_point& tp,
+                         TimePrecision precision, char* out);
+
+// UTC ISO8601 "YYYY-mm-ddTHH:MM:SS.fffZ"，写入 out 并返回长度
+std::size_t format_utc(const std::chrono::system_clock::time_point& tp,
+                       TimePrecision precision, char* out);
+
+inline std::string local_string(const std::chrono::system_clock::time_point& tp,
+                                TimePrecision precision = TimePrecision::Milliseconds) {
+    char buf[kMaxTimestampLen];
+    return std::string(buf, format_local(tp, precision, buf));
+}
+
+inline std::string utc_string(const std::chrono::system_clock::time_point& tp,
+                              TimePrecision precision = TimePrecision::Milliseconds) {
+    char buf[kMaxTimestampLen];
+    return std::string(buf, format_utc(tp, precision, buf));
+}
+
+} // namespace XZeroTime
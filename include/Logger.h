@@ -1,18 +1,35 @@
 #pragma once
 
+#include "FormatBuffer.h"
 #include "LogConfig.h"
+#include "LogField.h"
+#include "LogSite.h"
+#include "LogStats.h"
+#include "LogTime.h"
 
+#include <atomic>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <cstddef>
+#include <initializer_list>
 #include <string>
 
+namespace XZeroRate {
+class Suppression;
+} // namespace XZeroRate
+
 // 基础日志接口，提供等级转换与时间获取工具
+// 等级过滤统一由原子位掩码完成：每个等级占一位，热路径只有一次 relaxed load 与一次按位与
 class Logger {
 public:
+    // 全部等级的掩码
+    static const unsigned kAllLevels = 0xFu;
+
     Logger() = default;
     virtual ~Logger() = default;
 
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
     // 线程安全由具体实现保证；接口保持 const，便于并发调用
     virtual void log(LoggerLevel level, const std::string& message,
                      int errorCode = 0,
@@ -20,6 +37,160 @@ public:
                      int line = 0,
                      const char* func = nullptr) const = 0;
 
+    // 以指针+长度传入消息，避免调用方为格式化结果构造 std::string
+    // 默认实现转发到 log()，具体实现可覆盖以省去一次拷贝
+    virtual void log_n(LoggerLevel level, const char* message, std::size_t length,
+                       int errorCode = 0,
+                       const char* file = nullptr,
+                       int line = 0,
+                       const char* func = nullptr) const {
+        log(level, std::string(message, length), errorCode, file, line, func);
+    }
+
+    // 携带结构化字段：JSON 中输出为原生数值 / 布尔 / 字符串，HumanFriendly 中追加为 k=v
+    // 默认实现把字段渲染为 k=v 拼接到消息后转发到 log_n()，具体实现可覆盖以按类型保存字段
+    virtual void log_fields(LoggerLevel level, const char* message, std::size_t length,
+                            const LogField* fields, std::size_t count,
+                            int errorCode = 0,
+                            const char* file = nullptr,
+                            int line = 0,
+                            const char* func = nullptr) const {
+        std::string encoded;
+        XZeroFields::encode(fields, count, encoded);
+        std::string text(message, length);
+        XZeroFields::append_human(text, encoded);
+        log_n(level, text.data(), text.size(), errorCode, file, line, func);
+    }
+
+    // logger->log(LoggerLevel::INFO, "req done", {{"status", 200}, {"latency_us", 1234.5}, {"ok", true}})
+    // 字段以初始化列表传入，位于调用方栈上，无堆分配
+    void log(LoggerLevel level, const std::string& message, std::initializer_list<LogField> fields,
+             int errorCode = 0,
+             const char* file = nullptr,
+             int line = 0,
+             const char* func = nullptr) const {
+        log_fields(level, message.data(), message.size(), fields.begin(), fields.size(),
+                   errorCode, file, line, func);
+    }
+
+    // 带调用点描述符的入口（便捷宏使用）：源信息以一个常驻指针传递，格式化时直接使用预渲染片段
+    // 默认实现展开为 file / line / func 转发到 log_fields()，具体实现可覆盖以保留描述符
+    virtual void log_site(const LogSite& site, LoggerLevel level,
+                          const char* message, std::size_t length,
+                          int errorCode = 0,
+                          const LogField* fields = nullptr,
+                          std::size_t count = 0) const {
+        log_fields(level, message, length, fields, count, errorCode, site.file, site.line, site.func);
+    }
+
+    void log_at(const LogSite& site, LoggerLevel level, const std::string& message,
+                int errorCode = 0) const {
+        log_site(site, level, message.data(), message.size(), errorCode);
+    }
+
+    void log_at(const LogSite& site, LoggerLevel level, const std::string& message,
+                std::initializer_list<LogField> fields, int errorCode = 0) const {
+        log_site(site, level, message.data(), message.size(), errorCode, fields.begin(), fields.size());
+    }
+
+    // 限流 / 折叠宏在调用点开始抑制时登记其计数（见 LogRateLimit.h），由实现择机补报尚未报告的条数；
+    // 默认不登记，抑制的条数在该调用点下次放行时补报
+    virtual void defer_suppressed(XZeroRate::Suppression& suppression, const LogSite& site,
+                                  LoggerLevel level) const {
+        (void)suppression;
+        (void)site;
+        (void)level;
+    }
+
+    // 自身指标快照（队列深度、丢弃 / 过滤计数、写出耗时等）；不带后端的实现返回全零
+    virtual LogStatsSnapshot stats() const { return LogStatsSnapshot(); }
+
+    // "{}" 占位符格式化：logger->logf(LoggerLevel::INFO, "user={} latency={}us", id, us)
+    // 结果写入线程局部的固定容量缓冲，常见情况下无堆分配
+    template <typename... Args>
+    void logf(LoggerLevel level, const char* fmt, const Args&... args) const {
+        if (!should_log(level)) return;
+        logf_at(level, 0, nullptr, 0, nullptr, fmt, args...);
+    }
+
+    // 带错误码与源信息的格式化版本；不做等级预检，供 XZERO_*F 宏在预检通过后调用
+    template <typename... Args>
+    void logf_at(LoggerLevel level, int errorCode, const char* file, int line, const char* func,
+                 const char* fmt, const Args&... args) const {
+        XZeroFmt::ScopedBuffer buf;
+        XZeroFmt::format_to(buf.get(), fmt, args...);
+        log_n(level, buf.get().data(), buf.get().size(), errorCode, file, line, func);
+    }
+
+    // 调用点版本；不做等级预检，供 XZERO_*F 宏在预检通过后调用
+    template <typename... Args>
+    void logf_at(const LogSite& site, LoggerLevel level, int errorCode,
+                 const char* fmt, const Args&... args) const {
+        XZeroFmt::ScopedBuffer buf;
+        XZeroFmt::format_to(buf.get(), fmt, args...);
+        log_site(site, level, buf.get().data(), buf.get().size(), errorCode);
+    }
+
+    // 调用前的廉价预检：宏在构造消息前先询问，避免为被过滤的日志拼接字符串
+    // 除写出的等级外，也放行仅供飞行记录器留存的等级（高 4 位）
+    bool should_log(LoggerLevel level) const {
+        const unsigned mask = level_mask_.load(std::memory_order_relaxed);
+        return ((mask | (mask >> kCaptureShift)) & level_bit(level)) != 0;
+    }
+
+    // 该等级是否写出（should_log 通过但这里为 false 的记录只进入飞行记录器）
+    bool level_enabled(LoggerLevel level) const {
+        return (level_mask_.load(std::memory_order_relaxed) & level_bit(level)) != 0;
+    }
+
+    // 运行时调整等级（线程安全，立即对所有线程生效）
+    // set_level：启用 level 及更严重的等级；set_level_enabled：单独开关某个等级
+    void set_level(LoggerLevel level) {
+        set_level_mask(mask_at_least(level));
+    }
+    void set_level_enabled(LoggerLevel level, bool enabled) {
+        if (enabled) {
+            level_mask_.fetch_or(level_bit(level), std::memory_order_relaxed);
+        } else {
+            level_mask_.fetch_and(~level_bit(level), std::memory_order_relaxed);
+        }
+    }
+    void set_level_mask(unsigned mask) {
+        replace_bits(kAllLevels, mask & kAllLevels);
+    }
+    unsigned level_mask() const { return level_mask_.load(std::memory_order_relaxed) & kAllLevels; }
+
+    static constexpr unsigned level_bit(LoggerLevel level) {
+        return 1u << static_cast<unsigned>(level);
+    }
+
+    // 由配置的 onlyLevels / disableLevels 得到等级掩码：only 非空时仅允许命中，禁用表次之
+    static unsigned level_mask_from(const LoggerConfig& cfg) {
+        unsigned mask = kAllLevels;
+        if (!cfg.onlyLevels.empty()) {
+            mask = 0;
+            for (LoggerLevel level : cfg.onlyLevels) mask |= level_bit(level);
+        }
+        for (LoggerLevel level : cfg.disableLevels) mask &= ~level_bit(level);
+        return mask;
+    }
+
+    // severity 不低于 level 的全部等级
+    static constexpr unsigned mask_at_least(LoggerLevel level) {
+        return (severity(LoggerLevel::DEBUG) >= severity(level) ? level_bit(LoggerLevel::DEBUG) : 0u) |
+               (severity(LoggerLevel::INFO) >= severity(level) ? level_bit(LoggerLevel::INFO) : 0u) |
+               (severity(LoggerLevel::WARN) >= severity(level) ? level_bit(LoggerLevel::WARN) : 0u) |
+               level_bit(LoggerLevel::ERROR);
+    }
+
+    // 严重程度：DEBUG < INFO < WARN < ERROR（与枚举声明顺序无关），与 XZERO_LEVEL_* 对应
+    static constexpr int severity(LoggerLevel level) {
+        return level == LoggerLevel::DEBUG ? 0
+             : level == LoggerLevel::INFO  ? 1
+             : level == LoggerLevel::WARN  ? 2
+             : 3;
+    }
+
     static std::string level_to_string(LoggerLevel level) {
         switch (level) {
         case LoggerLevel::INFO:
@@ -35,66 +206,179 @@ public:
         }
     }
 
-    // 使用 chrono + put_time 获取线程安全的时间戳
+    // 线程安全的本地时间戳（毫秒），底层按线程缓存秒级前缀
     static std::string current_time() {
-        const auto now = std::chrono::system_clock::now();
-        const auto time = std::chrono::system_clock::to_time_t(now);
-        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                            now.time_since_epoch()) %
-                        1000;
-        std::tm tm{};
-#if defined(_WIN32)
-        localtime_s(&tm, &time);
-#else
-        localtime_r(&time, &tm);
-#endif
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S")
-            << "." << std::setw(3) << std::setfill('0') << ms.count();
-        return oss.str();
+        return format_time(std::chrono::system_clock::now());
     }
 
     // UTC ISO8601 带毫秒，适用于 JSON
     static std::string current_time_iso8601_utc() {
-        const auto now = std::chrono::system_clock::now();
-        const auto time = std::chrono::system_clock::to_time_t(now);
-        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                            now.time_since_epoch()) %
-                        1000;
-        std::tm tm{};
-#if defined(_WIN32)
-        gmtime_s(&tm, &time);
-#else
-        gmtime_r(&time, &tm);
-#endif
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S")
-            << "." << std::setw(3) << std::setfill('0') << ms.count()
-            << "Z";
-        return oss.str();
+        return format_time_iso8601_utc(std::chrono::system_clock::now());
+    }
+
+    // 格式化指定时刻（本地时间），供延迟格式化使用
+    static std::string format_time(const std::chrono::system_clock::time_point& tp) {
+        return XZeroTime::local_string(tp);
+    }
+
+    // 格式化指定时刻（UTC ISO8601）
+    static std::string format_time_iso8601_utc(const std::chrono::system_clock::time_point& tp) {
+        return XZeroTime::utc_string(tp);
+    }
+
+protected:
+    // 额外放行但不写出的等级（飞行记录器使用），与写出等级共用一个原子变量
+    void set_capture_mask(unsigned mask) {
+        replace_bits(kAllLevels << kCaptureShift, (mask & kAllLevels) << kCaptureShift);
     }
+
+private:
+    static const unsigned kCaptureShift = 4;
+
+    void replace_bits(unsigned field, unsigned bits) {
+        unsigned cur = level_mask_.load(std::memory_order_relaxed);
+        while (!level_mask_.compare_exchange_weak(cur, (cur & ~field) | bits,
+                                                  std::memory_order_relaxed)) {
+        }
+    }
+
+    // 低 4 位：写出的等级；高 4 位：仅供飞行记录器留存的等级
+    std::atomic<unsigned> level_mask_{kAllLevels};
 };
 
+// 编译期等级阈值：低于 XZERO_MIN_LEVEL 的便捷宏直接编译为空，消息表达式不会被求值
+// 例如 Release 构建可添加 -DXZERO_MIN_LEVEL=XZERO_LEVEL_INFO 去掉全部 DEBUG 日志
+#define XZERO_LEVEL_DEBUG 0
+#define XZERO_LEVEL_INFO 1
+#define XZERO_LEVEL_WARN 2
+#define XZERO_LEVEL_ERROR 3
+#define XZERO_LEVEL_OFF 4
+
+#ifndef XZERO_MIN_LEVEL
+#define XZERO_MIN_LEVEL XZERO_LEVEL_DEBUG
+#endif
+
 // 便捷宏：自动捕获文件/行/函数，避免用户手填
-#define XZERO_LOG(logger, level, message, errorCode) \
-    (logger)->log((level), (message), (errorCode), __FILE__, __LINE__, __func__)
+// 先做编译期阈值与 should_log 检查，通过后才求值消息表达式；
+// 源信息为该调用点的静态描述符（见 LogSite.h），首次放行时构造一次
+#define XZERO_LOG(logger, level, message, errorCode)                        \
+    do {                                                                    \
+        const LoggerLevel xzero_level_ = (level);                           \
+        if (Logger::severity(xzero_level_) >= XZERO_MIN_LEVEL &&            \
+            (logger)->should_log(xzero_level_)) {                           \
+            XZERO_SITE(xzero_site_);                                        \
+            (logger)->log_at(xzero_site_, xzero_level_, (message), (errorCode)); \
+        }                                                                   \
+    } while (0)
 
-// 级别便捷别名，默认 errorCode = 0
-#define XZERO_INFO(logger, message) \
-    XZERO_LOG((logger), LoggerLevel::INFO, (message), 0)
-#define XZERO_WARN(logger, message) \
-    XZERO_LOG((logger), LoggerLevel::WARN, (message), 0)
+// 结构化字段：XZERO_LOG_FIELDS(logger, LoggerLevel::INFO, "req done", {"status", 200}, {"ok", true});
+// 字段写在消息之后，各自用花括号包裹；预检通过后才构造字段
+#define XZERO_LOG_FIELDS(logger, level, message, ...)                       \
+    do {                                                                    \
+        const LoggerLevel xzero_level_ = (level);                           \
+        if (Logger::severity(xzero_level_) >= XZERO_MIN_LEVEL &&            \
+            (logger)->should_log(xzero_level_)) {                           \
+            XZERO_SITE(xzero_site_);                                        \
+            (logger)->log_at(xzero_site_, xzero_level_, (message), {__VA_ARGS__}); \
+        }                                                                   \
+    } while (0)
+
+// 被编译期裁剪的宏：参数仅出现在 sizeof 中，不求值也不产生未使用告警
+#define XZERO_LOG_DISCARD(logger, message, errorCode) \
+    do {                                              \
+        (void)sizeof((logger));                       \
+        (void)sizeof((message));                      \
+        (void)sizeof((errorCode));                    \
+    } while (0)
+
+// 级别便捷别名，默认 errorCode = 0；带 _E 后缀的版本携带错误码
+#if XZERO_MIN_LEVEL <= XZERO_LEVEL_DEBUG
 #define XZERO_DEBUG(logger, message) \
     XZERO_LOG((logger), LoggerLevel::DEBUG, (message), 0)
-#define XZERO_ERROR(logger, message) \
-    XZERO_LOG((logger), LoggerLevel::ERROR, (message), 0)
+#define XZERO_DEBUG_E(logger, message, err) \
+    XZERO_LOG((logger), LoggerLevel::DEBUG, (message), (err))
+#else
+#define XZERO_DEBUG(logger, message) XZERO_LOG_DISCARD((logger), (message), 0)
+#define XZERO_DEBUG_E(logger, message, err) XZERO_LOG_DISCARD((logger), (message), (err))
+#endif
 
-// 带错误码的快捷宏
+#if XZERO_MIN_LEVEL <= XZERO_LEVEL_INFO
+#define XZERO_INFO(logger, message) \
+    XZERO_LOG((logger), LoggerLevel::INFO, (message), 0)
 #define XZERO_INFO_E(logger, message, err) \
     XZERO_LOG((logger), LoggerLevel::INFO, (message), (err))
+#else
+#define XZERO_INFO(logger, message) XZERO_LOG_DISCARD((logger), (message), 0)
+#define XZERO_INFO_E(logger, message, err) XZERO_LOG_DISCARD((logger), (message), (err))
+#endif
+
+#if XZERO_MIN_LEVEL <= XZERO_LEVEL_WARN
+#define XZERO_WARN(logger, message) \
+    XZERO_LOG((logger), LoggerLevel::WARN, (message), 0)
 #define XZERO_WARN_E(logger, message, err) \
     XZERO_LOG((logger), LoggerLevel::WARN, (message), (err))
-#define XZERO_DEBUG_E(logger, message, err) \
-    XZERO_LOG((logger), LoggerLevel::DEBUG, (message), (err))
+#else
+#define XZERO_WARN(logger, message) XZERO_LOG_DISCARD((logger), (message), 0)
+#define XZERO_WARN_E(logger, message, err) XZERO_LOG_DISCARD((logger), (message), (err))
+#endif
+
+#if XZERO_MIN_LEVEL <= XZERO_LEVEL_ERROR
+#define XZERO_ERROR(logger, message) \
+    XZERO_LOG((logger), LoggerLevel::ERROR, (message), 0)
 #define XZERO_ERROR_E(logger, message, err) \
     XZERO_LOG((logger), LoggerLevel::ERROR, (message), (err))
+#else
+#define XZERO_ERROR(logger, message) XZERO_LOG_DISCARD((logger), (message), 0)
+#define XZERO_ERROR_E(logger, message, err) XZERO_LOG_DISCARD((logger), (message), (err))
+#endif
+
+// "{}" 占位符格式化宏：XZERO_INFOF(logger, "user={} latency={}us", id, us)
+// 同样先做编译期阈值与 should_log 预检，通过后才求值参数并格式化
+#define XZERO_LOGF(logger, level, errorCode, ...)                           \
+    do {                                                                    \
+        const LoggerLevel xzero_level_ = (level);                           \
+        if (Logger::severity(xzero_level_) >= XZERO_MIN_LEVEL &&            \
+            (logger)->should_log(xzero_level_)) {                           \
+            XZERO_SITE(xzero_site_);                                        \
+            (logger)->logf_at(xzero_site_, xzero_level_, (errorCode), __VA_ARGS__); \
+        }                                                                   \
+    } while (0)
+
+#define XZERO_LOGF_DISCARD(logger, errorCode, ...)                 \
+    do {                                                           \
+        (void)sizeof((logger));                                    \
+        (void)sizeof((errorCode));                                 \
+        (void)sizeof(XZeroFmt::discard(__VA_ARGS__));              \
+    } while (0)
+
+#if XZERO_MIN_LEVEL <= XZERO_LEVEL_DEBUG
+#define XZERO_DEBUGF(logger, ...) XZERO_LOGF((logger), LoggerLevel::DEBUG, 0, __VA_ARGS__)
+#define XZERO_DEBUGF_E(logger, err, ...) XZERO_LOGF((logger), LoggerLevel::DEBUG, (err), __VA_ARGS__)
+#else
+#define XZERO_DEBUGF(logger, ...) XZERO_LOGF_DISCARD((logger), 0, __VA_ARGS__)
+#define XZERO_DEBUGF_E(logger, err, ...) XZERO_LOGF_DISCARD((logger), (err), __VA_ARGS__)
+#endif
+
+#if XZERO_MIN_LEVEL <= XZERO_LEVEL_INFO
+#define XZERO_INFOF(logger, ...) XZERO_LOGF((logger), LoggerLevel::INFO, 0, __VA_ARGS__)
+#define XZERO_INFOF_E(logger, err, ...) XZERO_LOGF((logger), LoggerLevel::INFO, (err), __VA_ARGS__)
+#else
+#define XZERO_INFOF(logger, ...) XZERO_LOGF_DISCARD((logger), 0, __VA_ARGS__)
+#define XZERO_INFOF_E(logger, err, ...) XZERO_LOGF_DISCARD((logger), (err), __VA_ARGS__)
+#endif
+
+#if XZERO_MIN_LEVEL <= XZERO_LEVEL_WARN
+#define XZERO_WARNF(logger, ...) XZERO_LOGF((logger), LoggerLevel::WARN, 0, __VA_ARGS__)
+#define XZERO_WARNF_E(logger, err, ...) XZERO_LOGF((logger), LoggerLevel::WARN, (err), __VA_ARGS__)
+#else
+#define XZERO_WARNF(logger, ...) XZERO_LOGF_DISCARD((logger), 0, __VA_ARGS__)
+#define XZERO_WARNF_E(logger, err, ...) XZERO_LOGF_DISCARD((logger), (err), __VA_ARGS__)
+#endif
+
+#if XZERO_MIN_LEVEL <= XZERO_LEVEL_ERROR
+#define XZERO_ERRORF(logger, ...) XZERO_LOGF((logger), LoggerLevel::ERROR, 0, __VA_ARGS__)
+#define XZERO_ERRORF_E(logger, err, ...) XZERO_LOGF((logger), LoggerLevel::ERROR, (err), __VA_ARGS__)
+#else
+#define XZERO_ERRORF(logger, ...) XZERO_LOGF_DISCARD((logger), 0, __VA_ARGS__)
+#define XZERO_ERRORF_E(logger, err, ...) XZERO_LOGF_DISCARD((logger), (err), __VA_ARGS__)
+#endif
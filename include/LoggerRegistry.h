@@ -0,0 +1,52 @@
+#pragma once
+
+#include "FileLogger.h"
+#include "LogConfig.h"
+#include "Logger.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// 命名日志器注册表：按层级名称（如 "net.http"）获取日志器
+// - 配置与等级按名称前缀继承："net" 的设置作用于 "net.http"、"net.tcp" 等未单独设置的子孙；
+// - 输出目标相同的日志器共享一个 LogBackend（队列、分发线程、文件句柄）；
+// - get() 返回的指针在进程内一直有效，可缓存后反复使用（见 XZERO_NAMED_LOGGER）。
+// 进程退出时注册表析构，写出各后端中剩余的记录。
+class LoggerRegistry {
+public:
+    static LoggerRegistry& instance();
+
+    // 设置某名称子树的配置，对此后首次创建的日志器生效；空名称表示根（默认为 LoggerConfig{}）
+    void configure(const std::string& name, const LoggerConfig& cfg);
+
+    // 获取或创建命名日志器；配置错误（如路径无法打开）时抛出 std::runtime_error
+    Logger* get(const std::string& name);
+
+    // 设置等级：作用于该名称本身及其未单独设置等级的子孙（已创建的日志器立即生效）
+    void set_level(const std::string& name, LoggerLevel level);
+    // 以等级掩码设置（见 Logger::level_bit），0 表示关闭该子树的全部输出
+    void set_level_mask(const std::string& name, unsigned mask);
+    // 对全部已创建日志器所在的后端开关格式化字段
+    void set_format_flag(LogFormatter::FormatFlag flag, bool enabled);
+
+    LoggerRegistry(const LoggerRegistry&) = delete;
+    LoggerRegistry& operator=(const LoggerRegistry&) = delete;
+
+private:
+    LoggerRegistry() = default;
+
+    std::mutex mutex_;
+    std::map<std::string, LoggerConfig> configs_;
+    std::map<std::string, unsigned> levels_; // 名称 -> 等级掩码
+    std::map<std::string, std::unique_ptr<FileLogger>> loggers_;
+};
+
+// 在调用点缓存命名日志器句柄，仅首次执行时查表；name 须为字符串字面量
+// 用法：XZERO_INFO(XZERO_NAMED_LOGGER("net.http"), "connected");
+#define XZERO_NAMED_LOGGER(name)                                               \
+    ([]() -> Logger* {                                                         \
+        static Logger* const xzero_handle_ = LoggerRegistry::instance().get(name); \
+        return xzero_handle_;                                                  \
+    }())
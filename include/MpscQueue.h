@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+// 有界无锁 MPSC 环形队列（基于槽位序号的 Vyukov 算法）
+// - 生产者：一次 CAS 抢占槽位 + 一次移动/拷贝，无互斥锁
+// - 消费者：单线程，支持批量出队
+// - 槽位与头尾计数器按缓存行对齐/填充，避免伪共享
+template <typename T>
+class MpscQueue {
+public:
+    static const std::size_t kCacheLine = 64;
+
+    explicit MpscQueue(std::size_t capacity) {
+        // 容量向上取整为 2 的幂，便于用掩码取模
+        std::size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+
+        // C++11 不保证 new 满足超对齐要求，手动对齐原始内存
+        std::size_t space = cap * sizeof(Slot) + kCacheLine;
+        raw_ = new char[space];
+        void* p = raw_;
+        p = std::align(kCacheLine, cap * sizeof(Slot), p, space);
+        slots_ = static_cast<Slot*>(p);
+        for (std::size_t i = 0; i < cap; ++i) {
+            new (&slots_[i]) Slot();
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos_.store(0, std::memory_order_relaxed);
+        dequeue_pos_.store(0, std::memory_order_relaxed);
+    }
+
+    ~MpscQueue() {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            slots_[i].~Slot();
+        }
+        delete[] raw_;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // 尝试入队；队列满时返回 false，调用方决定重试或丢弃
+    bool try_push(T&& value) {
+        std::size_t pos = 0;
+        Slot* slot = claim(pos);
+        if (!slot) return false;
+        slot->value = std::move(value);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value) {
+        std::size_t pos = 0;
+        Slot* slot = claim(pos);
+        if (!slot) return false;
+        slot->value = value;
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 单消费者出队；为空时返回 false
+    bool try_pop(T& out) {
+        const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[pos & mask_];
+        const std::size_t seq = slot.seq.load(std::memory_order_acquire);
+        if (seq != pos + 1) return false;
+        out = std::move(slot.value);
+        slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+        dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 单消费者批量出队：最多取 max 条写入输出迭代器，返回实际条数
+    template <typename OutputIt>
+    std::size_t pop_bulk(OutputIt out, std::size_t max) {
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        std::size_t n = 0;
+        while (n < max) {
+            Slot& slot = slots_[pos & mask_];
+            if (slot.seq.load(std::memory_order_acquire) != pos + 1) break;
+            *out++ = std::move(slot.value);
+            slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+            ++pos;
+            ++n;
+        }
+        dequeue_pos_.store(pos, std::memory_order_relaxed);
+        return n;
+    }
+
+    // 消费者侧判断：队首是否已有可读数据
+    bool empty() const {
+        const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        return slots_[pos & mask_].seq.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    // 近似长度（并发下仅供参考）
+    std::size_t size_approx() const {
+        const std::size_t head = enqueue_pos_.load(std::memory_order_relaxed);
+        const std::size_t tail = dequeue_pos_.load(std::memory_order_relaxed);
+        return head >= tail ? head - tail : 0;
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // 累计入队条数（生产者抢占到的槽位数），供统计使用
+    std::size_t pushed_total() const { return enqueue_pos_.load(std::memory_order_relaxed); }
+
+    // 只读遍历已发布但尚未出队的元素（按入队顺序），不修改队列、不加锁、不分配内存，
+    // 供致命信号处理函数抢救数据使用；与生产者/消费者并发时读到的内容仅尽力而为
+    template <typename F>
+    void for_each_ready(F f) const {
+        const std::size_t head = enqueue_pos_.load(std::memory_order_acquire);
+        for (std::size_t pos = dequeue_pos_.load(std::memory_order_acquire); pos != head; ++pos) {
+            const Slot& slot = slots_[pos & mask_];
+            if (slot.seq.load(std::memory_order_acquire) == pos + 1) {
+                f(slot.value);
+            }
+        }
+    }
+
+private:
+    struct alignas(kCacheLine) Slot {
+        std::atomic<std::size_t> seq;
+        T value;
+    };
+
+    // 抢占一个可写槽位；满时返回 nullptr
+    Slot* claim(std::size_t& pos) {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot* slot = &slots_[pos & mask_];
+            const std::size_t seq = slot->seq.load(std::memory_order_acquire);
+            const std::intptr_t diff =
+                static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    return slot;
+                }
+            } else if (diff < 0) {
+                return nullptr; // 队列已满
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    char* raw_{nullptr};
+    Slot* slots_{nullptr};
+    std::size_t mask_{0};
+    char pad0_[kCacheLine];
+    std::atomic<std::size_t> enqueue_pos_;  // 生产者共享
+    char pad1_[kCacheLine - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> dequeue_pos_;  // 仅消费者写
+    char pad2_[kCacheLine - sizeof(std::atomic<std::size_t>)];
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "LogSink.h"
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 内存环形 sink：保留最近 capacity 条渲染后的文本，旧记录被覆盖
+// 适用于测试断言、诊断页面展示最近日志等场景
+class RingSink : public LogSink {
+public:
+    explicit RingSink(std::size_t capacity, LogFormat format = LogFormat::HumanFriendly);
+
+    void write(const LogEntry& entry) override;
+
+    // 按时间先后返回当前保留的全部行
+    std::vector<std::string> snapshot() const;
+    std::size_t size() const;
+    // 累计写入条数（含已被覆盖的）
+    std::size_t total() const;
+    void clear();
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::string> lines_;
+    std::size_t next_{0};
+    std::size_t total_{0};
+};
@@ -2,10 +2,15 @@
 
 #include "LoggerFactory.h"
 
+#include <string>
+
 // 日志工厂：XZeroLog
 class XZeroLog : public LoggerFactory {
 public:
     XZeroLog() = default;
     ~XZeroLog() override = default;
     std::unique_ptr<Logger> InitLogger(const LoggerConfig& config) override;
+
+    // 为当前线程设置名称，之后该线程的记录输出为 [TID:12345 name]（JSON 增加 thread_name 字段）
+    static void set_thread_name(const std::string& name);
 };
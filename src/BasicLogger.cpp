@@ -0,0 +1,153 @@
+#include "BasicLogger.h"
+
+#include "JsonEscape.h"
+#include "LogUtils.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace XZeroPolicy {
+
+Env::Env(const LoggerConfig& cfg) : precision(cfg.timePrecision), clock(cfg.clockSource) {
+    const std::string platform = detect_platform();
+    platform_human = "[" + platform + "] ";
+    platform_json = ",\"OS\":\"";
+    XZeroJson::escape_append(platform_json, platform);
+    platform_json.push_back('"');
+}
+
+namespace detail {
+
+void append_int(std::string& out, long long v) {
+    char buf[24];
+    char* end = buf + sizeof(buf);
+    char* p = end;
+    unsigned long long u = v < 0 ? 0ULL - static_cast<unsigned long long>(v)
+                                 : static_cast<unsigned long long>(v);
+    do {
+        *--p = static_cast<char>('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    if (v < 0) *--p = '-';
+    out.append(p, static_cast<std::size_t>(end - p));
+}
+
+void append_source(std::string& out, const Call& c) {
+    out.append(XZeroSite::basename(c.file));
+    if (c.line > 0) {
+        out.push_back(':');
+        append_int(out, c.line);
+    }
+    if (c.func && *c.func) {
+        out.push_back(' ');
+        out.append(c.func);
+    }
+}
+
+namespace {
+
+std::string& fields_scratch() {
+    static thread_local std::string scratch;
+    scratch.clear();
+    return scratch;
+}
+
+} // namespace
+
+void append_fields_human(std::string& out, const LogField* fields, std::size_t count) {
+    std::string& encoded = fields_scratch();
+    XZeroFields::encode(fields, count, encoded);
+    XZeroFields::append_human(out, encoded);
+}
+
+void append_fields_json(std::string& out, const LogField* fields, std::size_t count) {
+    std::string& encoded = fields_scratch();
+    XZeroFields::encode(fields, count, encoded);
+    XZeroFields::append_json(out, encoded);
+}
+
+std::string& line_buffer() {
+    static thread_local std::string line;
+    return line;
+}
+
+} // namespace detail
+
+void Source::json(std::string& out, const Call& c, const Env&) {
+    if (!c.file) return;
+    out.append(",\"logger\":\"", 11);
+    if (c.site) {
+        out.append(c.site->source_json);
+    } else {
+        // 源信息由文件名与函数名组成，先拼到暂存区再整体转义
+        static thread_local std::string source;
+        source.clear();
+        detail::append_source(source, c);
+        XZeroJson::escape_append(out, source);
+    }
+    out.push_back('"');
+}
+
+void Message::json(std::string& out, const Call& c, const Env&) {
+    out.append(",\"message\":\"", 12);
+    XZeroJson::escape_append(out, c.message, c.length);
+    out.push_back('"');
+}
+
+FileOutput::FileOutput(const LoggerConfig& cfg)
+    : path_(normalized_path(cfg.filePath)), policy_(cfg.flushPolicy),
+      bytes_threshold_(cfg.flushBytesThreshold),
+      interval_(cfg.flushTimeIntervalMs), last_flush_(std::chrono::steady_clock::now()) {
+    if (!is_path_valid(path_)) {
+        throw std::runtime_error("日志路径包含非法字符: " + path_);
+    }
+    if (!ensure_parent_directories(path_)) {
+        throw std::runtime_error("创建日志目录失败: " + path_);
+    }
+    if (!file_.open(path_, cfg.writeMode == FileWriteMode::Overwrite)) {
+        throw std::runtime_error("无法打开日志文件: " + path_);
+    }
+    // 追加模式下，在本轮写入前添加分割线
+    if (cfg.writeMode == FileWriteMode::Append) {
+        write(cfg.separator.data(), cfg.separator.size());
+    }
+}
+
+FileOutput::~FileOutput() {
+    // close 会写出仍在缓冲中的数据
+    file_.close();
+}
+
+void FileOutput::commit() {
+    bool flush_now = true;
+    switch (policy_) {
+    case FlushPolicy::EveryBatch:
+        break;
+    case FlushPolicy::EveryNBytes:
+        flush_now = file_.pending_bytes() >= bytes_threshold_;
+        break;
+    case FlushPolicy::Interval:
+        flush_now = std::chrono::steady_clock::now() - last_flush_ >= interval_;
+        break;
+    }
+    if (flush_now) flush();
+}
+
+void FileOutput::flush() {
+    if (file_.pending_bytes() == 0) return;
+    last_flush_ = std::chrono::steady_clock::now();
+    if (!file_.flush()) {
+        throw std::runtime_error("写入日志文件失败: " + path_);
+    }
+}
+
+void ConsoleOutput::write(const char* data, std::size_t n) {
+    std::fwrite(data, 1, n, stdout);
+    std::fputc('\n', stdout);
+}
+
+void ConsoleOutput::commit() {
+    std::fflush(stdout);
+}
+
+} // namespace XZeroPolicy
@@ -0,0 +1,309 @@
+#include "BinaryLog.h"
+
+#include "LogSite.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = {'X', 'Z', 'L', 'B'};
+const std::uint8_t kVersion = 3;
+const std::uint8_t kMinVersion = 1;
+
+const std::uint8_t kTagSite = 0x01;
+const std::uint8_t kTagThread = 0x02;
+const std::uint8_t kTagLog = 0x03;
+const std::uint8_t kTagName = 0x04;
+
+const std::uint8_t kFlagSameMessage = 0x01;
+const std::uint8_t kFlagNamed = 0x02;
+const std::uint8_t kFlagFields = 0x04;
+
+void put_varint(std::string& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+void put_zigzag(std::string& out, std::int64_t v) {
+    put_varint(out, (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+}
+
+void put_str(std::string& out, const char* s, std::size_t n) {
+    put_varint(out, n);
+    out.append(s, n);
+}
+
+void put_str(std::string& out, const std::string& s) {
+    put_str(out, s.data(), s.size());
+}
+
+std::int64_t to_us(const std::chrono::system_clock::time_point& tp) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+}
+
+// 顺序读取游标，越界时置 ok = false
+struct Reader {
+    const std::string& data;
+    std::size_t pos;
+    bool ok;
+
+    std::uint8_t u8() {
+        if (pos >= data.size()) {
+            ok = false;
+            return 0;
+        }
+        return static_cast<std::uint8_t>(data[pos++]);
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const std::uint8_t b = u8();
+            if (!ok) return 0;
+            v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return v;
+        }
+        ok = false;
+        return 0;
+    }
+
+    std::int64_t zigzag() {
+        const std::uint64_t v = varint();
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+
+    std::string str() {
+        const std::uint64_t n = varint();
+        if (!ok || n > data.size() - pos) {
+            ok = false;
+            return std::string();
+        }
+        std::string s = data.substr(pos, static_cast<std::size_t>(n));
+        pos += static_cast<std::size_t>(n);
+        return s;
+    }
+};
+
+} // namespace
+
+namespace XZeroBinary {
+
+std::size_t Encoder::SiteKeyHash::operator()(const SiteKey& k) const {
+    std::size_t h = std::hash<const void*>()(k.file);
+    h ^= std::hash<int>()(k.line) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<const void*>()(k.func) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+}
+
+Encoder::Encoder(const std::string& platform) : platform_(platform) {}
+
+void Encoder::reset() {
+    header_written_ = false;
+    next_site_id_ = 1;
+    sites_.clear();
+    described_.clear();
+    threads_.clear();
+    names_.clear();
+}
+
+Encoder::SiteState Encoder::register_site(const LogRecord& rec, std::string& out) {
+    SiteState st;
+    st.id = next_site_id_++;
+    out.push_back(static_cast<char>(kTagSite));
+    put_varint(out, st.id);
+    put_str(out, rec.file, std::strlen(rec.file));
+    put_varint(out, static_cast<std::uint64_t>(rec.line > 0 ? rec.line : 0));
+    put_str(out, rec.func ? rec.func : "", rec.func ? std::strlen(rec.func) : 0);
+    return st;
+}
+
+void Encoder::encode(const LogRecord& rec, std::string& out) {
+    const std::int64_t now_us = to_us(rec.timestamp);
+    if (!header_written_) {
+        out.append(kMagic, sizeof(kMagic));
+        out.push_back(static_cast<char>(kVersion));
+        put_str(out, platform_);
+        put_varint(out, static_cast<std::uint64_t>(now_us));
+        last_us_ = now_us;
+        header_written_ = true;
+    }
+
+    // 调用点首次出现时登记；经宏记录的按描述符指针查找，其余按 file/line/func 查找
+    std::uint64_t site_id = 0;
+    SiteState* site = nullptr;
+    if (rec.site) {
+        auto it = described_.find(rec.site);
+        if (it == described_.end()) {
+            it = described_.insert(std::make_pair(rec.site, register_site(rec, out))).first;
+        }
+        site = &it->second;
+    } else if (rec.file) {
+        const SiteKey key{rec.file, rec.line, rec.func};
+        auto it = sites_.find(key);
+        if (it == sites_.end()) {
+            it = sites_.insert(std::make_pair(key, register_site(rec, out))).first;
+        }
+        site = &it->second;
+    }
+    if (site) {
+        site_id = site->id;
+    }
+
+    // 线程首次出现时登记，之后只写短编号
+    auto tit = threads_.find(rec.threadId);
+    if (tit == threads_.end()) {
+        tit = threads_.insert(std::make_pair(rec.threadId, threads_.size())).first;
+        out.push_back(static_cast<char>(kTagThread));
+        put_varint(out, tit->second);
+        put_varint(out, rec.threadId);
+    }
+
+    // 日志器名首次出现时登记
+    std::uint64_t name_id = 0;
+    if (!rec.logger.empty()) {
+        auto nit = names_.find(rec.logger);
+        if (nit == names_.end()) {
+            nit = names_.insert(std::make_pair(rec.logger, names_.size())).first;
+            out.push_back(static_cast<char>(kTagName));
+            put_varint(out, nit->second);
+            put_str(out, rec.logger);
+        }
+        name_id = nit->second;
+    }
+
+    std::uint8_t flags = 0;
+    if (site && site->lastMessage == rec.message) {
+        flags |= kFlagSameMessage;
+    }
+    if (!rec.logger.empty()) {
+        flags |= kFlagNamed;
+    }
+    if (!rec.fields.empty()) {
+        flags |= kFlagFields;
+    }
+
+    out.push_back(static_cast<char>(kTagLog));
+    put_varint(out, site_id);
+    out.push_back(static_cast<char>(rec.level));
+    out.push_back(static_cast<char>(flags));
+    if (flags & kFlagNamed) {
+        put_varint(out, name_id);
+    }
+    put_zigzag(out, now_us - last_us_);
+    put_varint(out, tit->second);
+    put_zigzag(out, rec.errorCode);
+    if ((flags & kFlagSameMessage) == 0) {
+        put_str(out, rec.message);
+        if (site) site->lastMessage = rec.message;
+    }
+    if (flags & kFlagFields) {
+        put_str(out, rec.fields);
+    }
+    put_varint(out, rec.mdc ? rec.mdc->entries.size() : 0);
+    if (rec.mdc) {
+        for (const auto& kv : rec.mdc->entries) {
+            put_str(out, kv.first);
+            put_str(out, kv.second);
+        }
+    }
+    last_us_ = now_us;
+}
+
+bool Decoder::looks_binary(const std::string& data) {
+    return data.size() >= sizeof(kMagic) && std::memcmp(data.data(), kMagic, sizeof(kMagic)) == 0;
+}
+
+bool Decoder::decode(const std::string& data, const Callback& cb) {
+    Reader r{data, 0, true};
+    bool in_session = false;
+    while (r.ok && r.pos < data.size()) {
+        // 文本分割线等非二进制内容不会出现在 Binary 文件中；遇到文件头即开始新会话
+        if (data.size() - r.pos >= sizeof(kMagic) &&
+            std::memcmp(data.data() + r.pos, kMagic, sizeof(kMagic)) == 0) {
+            r.pos += sizeof(kMagic);
+            const std::uint8_t version = r.u8();
+            if (version < kMinVersion || version > kVersion) return false;
+            platform_ = r.str();
+            last_us_ = static_cast<std::int64_t>(r.varint());
+            sites_.clear();
+            site_index_.clear();
+            threads_.clear();
+            names_.clear();
+            in_session = true;
+            continue;
+        }
+        if (!in_session) return false;
+
+        const std::uint8_t tag = r.u8();
+        if (tag == kTagSite) {
+            const std::uint64_t id = r.varint();
+            Site site;
+            site.file = r.str();
+            site.line = static_cast<int>(r.varint());
+            site.func = r.str();
+            if (!r.ok) break;
+            site_index_[id] = sites_.size();
+            sites_.push_back(site);
+        } else if (tag == kTagThread) {
+            const std::uint64_t idx = r.varint();
+            threads_[idx] = r.varint();
+        } else if (tag == kTagName) {
+            const std::uint64_t idx = r.varint();
+            names_[idx] = r.str();
+        } else if (tag == kTagLog) {
+            LogRecord rec;
+            const std::uint64_t site_id = r.varint();
+            rec.level = static_cast<LoggerLevel>(r.u8());
+            const std::uint8_t flags = r.u8();
+            if (flags & kFlagNamed) {
+                auto nit = names_.find(r.varint());
+                if (nit == names_.end()) return false;
+                rec.logger = nit->second;
+            }
+            last_us_ += r.zigzag();
+            rec.timestamp = std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::microseconds(last_us_)));
+            rec.threadId = threads_[r.varint()];
+            rec.errorCode = static_cast<int>(r.zigzag());
+
+            Site* site = nullptr;
+            if (site_id != 0) {
+                auto it = site_index_.find(site_id);
+                if (it == site_index_.end()) return false;
+                site = &sites_[it->second];
+                rec.file = site->file.c_str();
+                rec.line = site->line;
+                rec.func = site->func.c_str();
+            }
+            if (flags & kFlagSameMessage) {
+                if (!site) return false;
+                rec.message = site->lastMessage;
+            } else {
+                rec.message = r.str();
+                if (site) site->lastMessage = rec.message;
+            }
+            if (flags & kFlagFields) {
+                rec.fields = r.str();
+            }
+            const std::uint64_t mdc_count = r.varint();
+            std::vector<XZeroMDC::Entry> mdc;
+            for (std::uint64_t i = 0; i < mdc_count && r.ok; ++i) {
+                std::string key = r.str();
+                mdc.emplace_back(std::move(key), r.str());
+            }
+            if (!r.ok) break;
+            rec.mdc = XZeroMDC::make_snapshot(std::move(mdc));
+            cb(rec, platform_);
+        } else {
+            return false;
+        }
+    }
+    return r.ok;
+}
+
+} // namespace XZeroBinary
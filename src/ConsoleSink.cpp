@@ -0,0 +1,31 @@
+#include "ConsoleSink.h"
+
+#include <iostream>
+
+ConsoleSink::ConsoleSink(const LoggerConfig& cfg)
+    : LogSink(cfg.logFormat == LogFormat::Binary ? LogFormat::HumanFriendly : cfg.logFormat),
+      color_(cfg.colorConsole) {}
+
+void ConsoleSink::write(const LogEntry& entry) {
+    const std::string& line = entry.text(format());
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (color_) {
+        const char* color = nullptr;
+        switch (entry.record.level) {
+        case LoggerLevel::ERROR: color = "\033[31m"; break;
+        case LoggerLevel::WARN:  color = "\033[33m"; break;
+        case LoggerLevel::INFO:  color = "\033[32m"; break;
+        case LoggerLevel::DEBUG: color = "\033[36m"; break;
+        default: color = ""; break;
+        }
+        std::cout << color << line << "\033[0m" << '\n';
+    } else {
+        std::cout << line << '\n';
+    }
+}
+
+void ConsoleSink::flush() {
+    // 每批 flush 一次，而非每行 std::endl
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::cout.flush();
+}
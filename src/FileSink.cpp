@@ -0,0 +1,296 @@
+#include "FileSink.h"
+
+#include "LogUtils.h"
+
+#include <cstdio>
+#include <map>
+#include <stdexcept>
+
+namespace {
+
+// 按路径共享的文件 sink 登记表，仅持弱引用；有意不释放，进程退出阶段仍可安全访问
+struct FileSinkRegistry {
+    std::mutex mutex;
+    std::map<std::string, std::weak_ptr<FileSink>> sinks;
+};
+
+FileSinkRegistry& file_sink_registry() {
+    static FileSinkRegistry* registry = new FileSinkRegistry;
+    return *registry;
+}
+
+// 与文件本身相关的配置：同一路径只打开一次，后来者的这些配置须与首次打开时一致
+std::string file_signature(const LoggerConfig& cfg) {
+    std::string sig;
+    auto add = [&sig](std::size_t value) {
+        sig += std::to_string(value);
+        sig += ',';
+    };
+    add(static_cast<std::size_t>(cfg.logFormat));
+    add(static_cast<std::size_t>(cfg.writeMode));
+    add(static_cast<std::size_t>(cfg.flushPolicy));
+    add(cfg.flushBytesThreshold);
+    add(cfg.flushTimeIntervalMs);
+    add(static_cast<std::size_t>(cfg.durability));
+    add(cfg.enableRotation);
+    add(cfg.maxFileSizeBytes);
+    add(cfg.maxBackupFiles);
+    add(cfg.rotationIntervalSeconds);
+    add(static_cast<std::size_t>(cfg.backupCompression));
+    add(cfg.maxBackupTotalBytes);
+    add(cfg.maxBackupAgeSeconds);
+    add(cfg.useMmap);
+    sig += cfg.separator;
+    return sig;
+}
+
+} // namespace
+
+FileSink::FileSink(const LoggerConfig& cfg)
+    : LogSink(cfg.logFormat), config_(cfg), encoder_(detect_platform()) {
+    // 规范化路径并校验合法性：仅允许 .log 或 .txt，自动修正后缀，并检测非法字符
+    config_.filePath = normalized_path(config_.filePath);
+    if (!is_path_valid(config_.filePath)) {
+        throw std::runtime_error("日志路径包含非法字符: " + config_.filePath);
+    }
+
+    // 若包含父路径则自动创建目录，提升鲁棒性
+    if (!ensure_parent_directories(config_.filePath)) {
+        throw std::runtime_error("创建日志目录失败: " + config_.filePath);
+    }
+
+    if (!open_file(config_.writeMode == FileWriteMode::Overwrite)) {
+        throw std::runtime_error("无法打开日志文件: " + config_.filePath);
+    }
+
+    // 记录当前文件大小，便于后续按大小滚动
+    current_size_ = file_.logical_size();
+    last_flush_ = std::chrono::steady_clock::now();
+}
+
+std::shared_ptr<FileSink> FileSink::open_shared(const LoggerConfig& cfg) {
+    const std::string key = normalized_path(cfg.filePath);
+    FileSinkRegistry& registry = file_sink_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::weak_ptr<FileSink>& slot = registry.sinks[key];
+    std::shared_ptr<FileSink> sink = slot.lock();
+    if (sink && file_signature(sink->config_) != file_signature(cfg)) {
+        throw std::runtime_error("日志文件已以不同的格式/滚动/写入配置打开: " + key);
+    }
+    if (!sink) {
+        if (cfg.enableRotation) {
+            sink = std::make_shared<RotatingFileSink>(cfg);
+        } else {
+            sink = std::make_shared<FileSink>(cfg);
+        }
+        slot = sink;
+    }
+    return sink;
+}
+
+FileSink::~FileSink() {
+    // close 会写出仍在缓冲中的数据
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.close();
+}
+
+bool FileSink::open_file(bool truncate) {
+    // mmap 依赖"记录不以 0 字节结尾"做崩溃恢复，仅用于文本格式；Binary 始终走 writev
+    if (config_.useMmap && format() != LogFormat::Binary) {
+        const std::size_t segment =
+            config_.maxFileSizeBytes > 0 ? config_.maxFileSizeBytes : 2 * 1024 * 1024;
+        return file_.open_mapped(config_.filePath, truncate, segment);
+    }
+    return file_.open(config_.filePath, truncate);
+}
+
+void FileSink::ensure_separator_once() {
+    if (config_.writeMode != FileWriteMode::Append) return;
+    if (format() == LogFormat::Binary) return; // 二进制以文件头区分会话
+    if (separator_written_) return;
+    if (!file_.is_open()) return;
+
+    // 追加模式下，在新一轮写入前添加分割线
+    file_.add_ref(config_.separator.data(), config_.separator.size());
+    file_.add_ref("\n", 1);
+    current_size_ += config_.separator.size() + 1;
+    bytes_written_.fetch_add(config_.separator.size() + 1, std::memory_order_relaxed);
+    separator_written_ = true;
+}
+
+void FileSink::write(const LogEntry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (format() != LogFormat::Binary) {
+        const std::string& line = entry.text(format());
+        before_write(line.size() + 1);
+        if (!file_.is_open()) return;
+        ensure_separator_once();
+        // 零拷贝：仅登记引用，批次结束时统一 writev
+        file_.add_ref(line.data(), line.size());
+        file_.add_ref("\n", 1);
+        current_size_ += line.size() + 1; // 维护当前文件大小
+        bytes_written_.fetch_add(line.size() + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (!file_.is_open()) return;
+    encoded_.clear();
+    encoder_.encode(entry.record, encoded_);
+    if (before_write(encoded_.size())) {
+        // 新文件需重新写入文件头与调用点/线程登记
+        encoded_.clear();
+        encoder_.encode(entry.record, encoded_);
+    }
+    // 编码缓冲逐条复用，需拷贝进文件缓冲
+    file_.add_copy(encoded_.data(), encoded_.size());
+    current_size_ += encoded_.size();
+    bytes_written_.fetch_add(encoded_.size(), std::memory_order_relaxed);
+}
+
+void FileSink::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) return;
+
+    bool flush_now = true;
+    const auto now = std::chrono::steady_clock::now();
+    switch (config_.flushPolicy) {
+    case FlushPolicy::EveryBatch:
+        break;
+    case FlushPolicy::EveryNBytes:
+        flush_now = file_.pending_bytes() >= config_.flushBytesThreshold;
+        break;
+    case FlushPolicy::Interval:
+        flush_now = now - last_flush_ >= std::chrono::milliseconds(config_.flushTimeIntervalMs);
+        break;
+    }
+    if (flush_now) last_flush_ = now;
+    if (!(flush_now ? write_out() : file_.end_batch(false))) {
+        throw std::runtime_error("写入日志文件失败: " + config_.filePath);
+    }
+}
+
+void FileSink::on_idle() {
+    // 分发线程空闲时兜底：缓冲数据最多滞留 flushTimeIntervalMs
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open() || file_.pending_bytes() == 0) return;
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_flush_ < std::chrono::milliseconds(config_.flushTimeIntervalMs)) return;
+    last_flush_ = now;
+    if (!write_out()) {
+        throw std::runtime_error("写入日志文件失败: " + config_.filePath);
+    }
+}
+
+void FileSink::flush_pending() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open() || file_.pending_bytes() == 0) return;
+    last_flush_ = std::chrono::steady_clock::now();
+    if (!write_out()) {
+        throw std::runtime_error("写入日志文件失败: " + config_.filePath);
+    }
+}
+
+void FileSink::sync() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) return;
+    if (!sync_out()) {
+        throw std::runtime_error("日志文件落盘失败: " + config_.filePath);
+    }
+}
+
+bool FileSink::sync_out() {
+    // 先写出缓冲（不受 flushPolicy 限制），落盘才能覆盖此前交给本 sink 的全部记录
+    if (file_.pending_bytes() > 0) {
+        last_flush_ = std::chrono::steady_clock::now();
+        if (!write_out()) return false;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok = file_.sync();
+    fsync_latency_ns_.record(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count()));
+    return ok;
+}
+
+bool FileSink::write_out() {
+    if (file_.pending_bytes() == 0) return file_.flush(); // mmap 模式：仅汇报写入失败
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok = file_.flush();
+    write_latency_ns_.record(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count()));
+    return ok;
+}
+
+void FileSink::collect_stats(LogStatsSnapshot& out) const {
+    out.bytes_written += bytes_written_.load(std::memory_order_relaxed);
+    out.rotations += rotations_.load(std::memory_order_relaxed);
+    out.write_latency_ns.merge(write_latency_ns_.snapshot());
+    out.fsync_latency_ns.merge(fsync_latency_ns_.snapshot());
+}
+
+void FileSink::emergency_flush() {
+    // 不取 mutex_：持锁的线程可能正是崩溃的线程
+    file_.emergency_flush();
+}
+
+void FileSink::close_file() {
+    // 关闭前写出缓冲，保证旧文件内容完整；开启落盘保证时先落盘，旧文件中的记录不因滚动而失去保证
+    if (config_.durability != Durability::None && !sync_out()) {
+        throw std::runtime_error("日志文件落盘失败: " + config_.filePath);
+    }
+    file_.close();
+}
+
+void FileSink::reopen_truncated() {
+    // 重新打开主文件，重置大小、分割线与二进制登记状态
+    const bool reopened = open_file(true);
+    current_size_ = 0;
+    separator_written_ = false;
+    encoder_.reset();
+    if (!reopened) {
+        throw std::runtime_error("滚动后无法重新打开日志文件: " + config_.filePath);
+    }
+}
+
+RotatingFileSink::RotatingFileSink(const LoggerConfig& cfg)
+    : FileSink(cfg), last_rotation_(std::chrono::system_clock::now()),
+      maintenance_(new LogMaintenance(config_)) {}
+
+void RotatingFileSink::wait_maintenance() {
+    maintenance_->wait_idle();
+}
+
+bool RotatingFileSink::before_write(std::size_t next_len) {
+    bool need_rotate = false;
+    const auto now = std::chrono::system_clock::now();
+
+    if (config_.maxFileSizeBytes > 0 &&
+        current_size_ + next_len > config_.maxFileSizeBytes) {
+        need_rotate = true;
+    }
+    if (!need_rotate && config_.rotationIntervalSeconds > 0) {
+        const auto interval = std::chrono::seconds(config_.rotationIntervalSeconds);
+        if (now - last_rotation_ >= interval) {
+            need_rotate = true;
+        }
+    }
+    if (need_rotate) {
+        rotate_files();
+        rotations_.fetch_add(1, std::memory_order_relaxed);
+        last_rotation_ = now;
+    }
+    return need_rotate;
+}
+
+void RotatingFileSink::rotate_files() {
+    close_file();
+
+    // 写线程只把主文件改名为暂存名；备份轮转、压缩与清理由后台线程完成
+    const std::string staged = maintenance_->staging_path();
+    if (std::rename(config_.filePath.c_str(), staged.c_str()) == 0) {
+        maintenance_->submit(staged);
+    }
+
+    reopen_truncated();
+}
@@ -0,0 +1,97 @@
+#include "FlightRecorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace {
+
+void lock_slot(std::atomic<bool>& busy) {
+    while (busy.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+extern "C" void xzero_flight_recorder_signal(int) {
+    FlightRecorder::request_dump_all();
+}
+
+} // namespace
+
+std::atomic<unsigned> FlightRecorder::dump_generation_{0};
+
+FlightRecorder::FlightRecorder(std::size_t capacity)
+    : slots_(new Slot[capacity == 0 ? 1 : capacity]),
+      capacity_(capacity == 0 ? 1 : capacity),
+      // 只响应创建之后发出的请求
+      seen_generation_(dump_generation_.load(std::memory_order_relaxed)) {}
+
+void FlightRecorder::record(LogRecord&& rec) {
+    const std::uint64_t seq = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[seq % capacity_];
+    lock_slot(slot.busy);
+    // 绕圈的慢写者不能覆盖更新的记录
+    if (!slot.used || slot.seq < seq) {
+        slot.rec = std::move(rec);
+        slot.seq = seq;
+        slot.used = true;
+    }
+    slot.busy.store(false, std::memory_order_release);
+}
+
+std::vector<LogRecord> FlightRecorder::drain() {
+    std::vector<std::pair<std::uint64_t, LogRecord>> taken;
+    taken.reserve(capacity_);
+    for (std::size_t i = 0; i < capacity_; ++i) {
+        Slot& slot = slots_[i];
+        lock_slot(slot.busy);
+        if (slot.used) {
+            taken.emplace_back(slot.seq, std::move(slot.rec));
+            slot.used = false;
+        }
+        slot.busy.store(false, std::memory_order_release);
+    }
+    std::sort(taken.begin(), taken.end(),
+              [](const std::pair<std::uint64_t, LogRecord>& a,
+                 const std::pair<std::uint64_t, LogRecord>& b) { return a.first < b.first; });
+
+    std::vector<LogRecord> out;
+    out.reserve(taken.size());
+    for (auto& item : taken) {
+        out.push_back(std::move(item.second));
+    }
+    return out;
+}
+
+bool FlightRecorder::acknowledge_request() {
+    const unsigned current = dump_generation_.load(std::memory_order_relaxed);
+    unsigned seen = seen_generation_.load(std::memory_order_relaxed);
+    return seen != current &&
+           seen_generation_.compare_exchange_strong(seen, current, std::memory_order_relaxed);
+}
+
+void FlightRecorder::request_dump_all() {
+    dump_generation_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FlightRecorder::install_dump_signal(int signo) {
+#if !defined(_WIN32)
+    struct sigaction sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = xzero_flight_recorder_signal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    if (::sigaction(signo, &sa, nullptr) != 0) {
+        throw std::runtime_error("安装飞行记录器信号处理失败: " + std::string(std::strerror(errno)));
+    }
+#else
+    if (std::signal(signo, xzero_flight_recorder_signal) == SIG_ERR) {
+        throw std::runtime_error("安装飞行记录器信号处理失败: " + std::to_string(signo));
+    }
+#endif
+}
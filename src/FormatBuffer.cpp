@@ -0,0 +1,66 @@
+#include "FormatBuffer.h"
+
+#include <cstdio>
+
+namespace {
+
+// 无符号整数逆序写入临时栈缓冲，返回起始位置
+char* write_unsigned(char* end, unsigned long long value) {
+    char* p = end;
+    do {
+        *--p = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    return p;
+}
+
+// 追加 snprintf 结果（n 为其返回值，截断时只取缓冲内的部分）
+void append_printed(XZeroFmt::Buffer& out, const char* buf, int n, std::size_t cap) {
+    if (n <= 0) return;
+    const std::size_t len = static_cast<std::size_t>(n) < cap ? static_cast<std::size_t>(n) : cap - 1;
+    out.append(buf, len);
+}
+
+} // namespace
+
+namespace XZeroFmt {
+
+void format_arg(Buffer& out, long long value) {
+    char buf[24];
+    char* end = buf + sizeof(buf);
+    // 取绝对值时避免 LLONG_MIN 溢出
+    const unsigned long long magnitude =
+        value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                  : static_cast<unsigned long long>(value);
+    char* p = write_unsigned(end, magnitude);
+    if (value < 0) *--p = '-';
+    out.append(p, static_cast<std::size_t>(end - p));
+}
+
+void format_arg(Buffer& out, unsigned long long value) {
+    char buf[24];
+    char* end = buf + sizeof(buf);
+    char* p = write_unsigned(end, value);
+    out.append(p, static_cast<std::size_t>(end - p));
+}
+
+void format_arg(Buffer& out, double value) {
+    // %.15g：保留 15 位有效数字且去掉多余的 0，写入栈缓冲不分配内存
+    char buf[32];
+    const int n = std::snprintf(buf, sizeof(buf), "%.15g", value);
+    append_printed(out, buf, n, sizeof(buf));
+}
+
+void format_arg(Buffer& out, long double value) {
+    char buf[48];
+    const int n = std::snprintf(buf, sizeof(buf), "%.18Lg", value);
+    append_printed(out, buf, n, sizeof(buf));
+}
+
+void format_arg(Buffer& out, const void* value) {
+    char buf[2 + 2 * sizeof(void*) + 1];
+    const int n = std::snprintf(buf, sizeof(buf), "%p", value);
+    append_printed(out, buf, n, sizeof(buf));
+}
+
+} // namespace XZeroFmt
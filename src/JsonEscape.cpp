@@ -0,0 +1,179 @@
+#include "JsonEscape.h"
+
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define XZERO_JSON_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const char kHex[] = "0123456789abcdef";
+
+// 转义单个字节（调用方已确认其需要转义）
+inline void escape_byte(std::string& out, unsigned char c) {
+    switch (c) {
+    case '\"': out.append("\\\"", 2); break;
+    case '\\': out.append("\\\\", 2); break;
+    case '\n': out.append("\\n", 2); break;
+    case '\r': out.append("\\r", 2); break;
+    case '\t': out.append("\\t", 2); break;
+    case '\b': out.append("\\b", 2); break;
+    case '\f': out.append("\\f", 2); break;
+    default: {
+        const char u[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0x0F]};
+        out.append(u, sizeof(u));
+        break;
+    }
+    }
+}
+
+inline bool needs_escape(unsigned char c) {
+    return c < 0x20 || c == '\"' || c == '\\';
+}
+
+// 标量尾部处理：同样按片段整体拷贝
+void escape_scalar_from(std::string& out, const char* data, std::size_t i, std::size_t n) {
+    std::size_t run = i;
+    for (; i < n; ++i) {
+        const unsigned char c = static_cast<unsigned char>(data[i]);
+        if (needs_escape(c)) {
+            out.append(data + run, i - run);
+            escape_byte(out, c);
+            run = i + 1;
+        }
+    }
+    out.append(data + run, n - run);
+}
+
+#if defined(XZERO_JSON_X86)
+
+inline unsigned ctz32(unsigned v) { return static_cast<unsigned>(__builtin_ctz(v)); }
+
+#if defined(__SSE2__)
+void escape_sse2_impl(std::string& out, const char* data, std::size_t n) {
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i ctrl_max = _mm_set1_epi8(0x1F);
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+    std::size_t run = 0; // 尚未拷贝的干净片段起点
+    while (i + 16 <= n) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // v <= 0x1F（无符号）等价于 subs_epu8(v, 0x1F) == 0
+        const __m128i ctrl = _mm_cmpeq_epi8(_mm_subs_epu8(v, ctrl_max), zero);
+        const __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                                      _mm_cmpeq_epi8(v, backslash)),
+                                         ctrl);
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+        while (mask != 0) {
+            const std::size_t pos = i + ctz32(mask);
+            out.append(data + run, pos - run);
+            escape_byte(out, static_cast<unsigned char>(data[pos]));
+            run = pos + 1;
+            mask &= mask - 1;
+        }
+        i += 16;
+    }
+    out.append(data + run, i - run);
+    escape_scalar_from(out, data, i, n);
+}
+#endif
+
+__attribute__((target("avx2")))
+void escape_avx2_impl(std::string& out, const char* data, std::size_t n) {
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i ctrl_max = _mm256_set1_epi8(0x1F);
+    const __m256i zero = _mm256_setzero_si256();
+    std::size_t i = 0;
+    std::size_t run = 0;
+    while (i + 32 <= n) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i ctrl = _mm256_cmpeq_epi8(_mm256_subs_epu8(v, ctrl_max), zero);
+        const __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                                                            _mm256_cmpeq_epi8(v, backslash)),
+                                            ctrl);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+        while (mask != 0) {
+            const std::size_t pos = i + ctz32(mask);
+            out.append(data + run, pos - run);
+            escape_byte(out, static_cast<unsigned char>(data[pos]));
+            run = pos + 1;
+            mask &= mask - 1;
+        }
+        i += 32;
+    }
+    out.append(data + run, i - run);
+    escape_scalar_from(out, data, i, n);
+}
+
+bool cpu_has_avx2() {
+    static const bool has = __builtin_cpu_supports("avx2") != 0;
+    return has;
+}
+
+#endif // XZERO_JSON_X86
+
+typedef void (*EscapeFn)(std::string&, const char*, std::size_t);
+
+struct Dispatch {
+    EscapeFn fn;
+    const char* name;
+};
+
+Dispatch select_impl() {
+#if defined(XZERO_JSON_X86)
+    if (cpu_has_avx2()) return Dispatch{&escape_avx2_impl, "avx2"};
+#if defined(__SSE2__)
+    return Dispatch{&escape_sse2_impl, "sse2"};
+#endif
+#endif
+    return Dispatch{&XZeroJson::escape_append_scalar, "scalar"};
+}
+
+const Dispatch& dispatch() {
+    static const Dispatch d = select_impl();
+    return d;
+}
+
+} // namespace
+
+namespace XZeroJson {
+
+void escape_append(std::string& out, const char* data, std::size_t n) {
+    out.reserve(out.size() + n + 16);
+    dispatch().fn(out, data, n);
+}
+
+const char* escape_impl_name() {
+    return dispatch().name;
+}
+
+void escape_append_scalar(std::string& out, const char* data, std::size_t n) {
+    escape_scalar_from(out, data, 0, n);
+}
+
+bool escape_append_sse2(std::string& out, const char* data, std::size_t n) {
+#if defined(XZERO_JSON_X86) && defined(__SSE2__)
+    escape_sse2_impl(out, data, n);
+    return true;
+#else
+    (void)out; (void)data; (void)n;
+    return false;
+#endif
+}
+
+bool escape_append_avx2(std::string& out, const char* data, std::size_t n) {
+#if defined(XZERO_JSON_X86)
+    if (cpu_has_avx2()) {
+        escape_avx2_impl(out, data, n);
+        return true;
+    }
+#endif
+    (void)out; (void)data; (void)n;
+    return false;
+}
+
+} // namespace XZeroJson
@@ -0,0 +1,1005 @@
+#include "LogBackend.h"
+
+#include "ConsoleSink.h"
+#include "FileSink.h"
+#include "FlightRecorder.h"
+#include "FormatBuffer.h"
+#include "LogCrash.h"
+#include "LogRateLimit.h"
+#include "LogThread.h"
+#include "LogTime.h"
+#include "LogUtils.h"
+#include "Logger.h"
+
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <ctime>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 共享后端登记表：按输出目标索引，仅持弱引用。
+// 有意不释放，保证进程退出阶段析构日志器时仍可安全访问。
+struct BackendRegistry {
+    std::mutex mutex;
+    std::map<std::string, std::weak_ptr<LogBackend>> backends;
+};
+
+BackendRegistry& backend_registry() {
+    static BackendRegistry* registry = new BackendRegistry;
+    return *registry;
+}
+
+// 后端相关配置的签名：写入共享后端的登记键，配置不同的日志器不会静默拿到别人的后端
+// 等级、飞行记录器与热加载属于各日志器自身，不参与比较
+std::string backend_signature(const LoggerConfig& cfg) {
+    std::string sig;
+    auto add = [&sig](std::size_t value) {
+        sig += std::to_string(value);
+        sig += ',';
+    };
+    add(static_cast<std::size_t>(cfg.logFormat));
+    add(cfg.asyncLogging);
+    add(cfg.batchSize);
+    add(cfg.flushIntervalMs);
+    add(cfg.queueCapacity);
+    add(static_cast<std::size_t>(cfg.overflowPolicy));
+    add(cfg.blockTimeoutMs);
+    add(cfg.spillMaxBytes);
+    add(static_cast<std::size_t>(cfg.flushPolicy));
+    add(cfg.flushBytesThreshold);
+    add(cfg.flushTimeIntervalMs);
+    add(cfg.deferredFormatting);
+    add(static_cast<std::size_t>(cfg.durability));
+    add(cfg.durabilityIntervalMs);
+    add(static_cast<std::size_t>(cfg.durabilityLevel));
+    add(cfg.includePlatform);
+    add(cfg.includeSource);
+    add(cfg.colorConsole);
+    add(cfg.includeMdc);
+    add(cfg.writeTime);
+    add(static_cast<std::size_t>(cfg.timePrecision));
+    add(static_cast<std::size_t>(cfg.clockSource));
+    add(cfg.asyncConsole);
+    add(cfg.crashHandler);
+    add(cfg.statsIntervalMs);
+    add(cfg.useErrorCode);
+    // 文件滚动与写入方式由 FileSink::open_shared 按路径校验，这里不重复
+    sig += cfg.spillPath;
+    sig += '|';
+    sig += cfg.crashLogPath;
+    return sig;
+}
+
+// 崩溃抢救记录的输出位置；返回空串表示写到 stderr
+// 仅 Human-Friendly + writev + 不滚动时直接追加到主文件（fd 在构造时打开一次，始终指向同一个 inode）；
+// 其余情况改写到 <主文件名>.crash.log：mmap 与 Binary 不能混入文本，Json 中混入文本行会破坏逐行解析，
+// 滚动会把主文件改名为暂存 / 备份甚至删除，预先打开的 fd 写入的内容将丢失或落入旧备份
+std::string crash_log_path(const LoggerConfig& cfg) {
+    if (!cfg.crashLogPath.empty()) return cfg.crashLogPath;
+    if (!cfg.toFile) return std::string();
+    const std::string path = normalized_path(cfg.filePath);
+    if (cfg.logFormat == LogFormat::HumanFriendly && !cfg.useMmap && !cfg.enableRotation) return path;
+    const std::size_t dot = path.find_last_of('.');
+    return path.substr(0, dot) + ".crash" + path.substr(dot);
+}
+
+int open_append(const std::string& path) {
+#if defined(_WIN32)
+    return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+}
+
+// 溢出文件的记录编码：只在本进程内回放，按本机字节序写入，源信息与线程标签直接保存指针（均常驻进程内）
+// [u32 总长][u8 等级][i64 时间戳][u64 线程][ptr 线程标签][ptr file][i32 line][ptr func][ptr 调用点][i32 错误码]
+// [ptr 落盘票据][u32 长度 + 消息][u32 长度 + 名称][u32 长度 + 字段编码][u32 MDC 数 + (u32 长度 + 键, u32 长度 + 值)*]
+template <typename T>
+void put_raw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put_string(std::string& out, const std::string& value) {
+    put_raw(out, static_cast<std::uint32_t>(value.size()));
+    out.append(value);
+}
+
+template <typename T>
+T get_raw(const char*& p) {
+    T value;
+    std::memcpy(&value, p, sizeof(value));
+    p += sizeof(value);
+    return value;
+}
+
+std::string get_string(const char*& p) {
+    const std::uint32_t n = get_raw<std::uint32_t>(p);
+    std::string value(p, n);
+    p += n;
+    return value;
+}
+
+void encode_spill(const LogBackend::Item& item, std::string& out) {
+    const LogRecord& rec = item.entry.record;
+    out.assign(sizeof(std::uint32_t), '\0');
+    put_raw(out, static_cast<std::uint8_t>(rec.level));
+    put_raw(out, static_cast<std::int64_t>(rec.timestamp.time_since_epoch().count()));
+    put_raw(out, rec.threadId);
+    put_raw(out, rec.thread);
+    put_raw(out, rec.file);
+    put_raw(out, static_cast<std::int32_t>(rec.line));
+    put_raw(out, rec.func);
+    put_raw(out, rec.site);
+    put_raw(out, static_cast<std::int32_t>(rec.errorCode));
+    put_raw(out, item.ticket); // 等待者在栈上持有票据，回放写出前不会返回
+    put_string(out, rec.message);
+    put_string(out, rec.logger);
+    put_string(out, rec.fields);
+    put_raw(out, static_cast<std::uint32_t>(rec.mdc ? rec.mdc->entries.size() : 0));
+    if (rec.mdc) {
+        for (const auto& kv : rec.mdc->entries) {
+            put_string(out, kv.first);
+            put_string(out, kv.second);
+        }
+    }
+    const std::uint32_t total = static_cast<std::uint32_t>(out.size());
+    std::memcpy(&out[0], &total, sizeof(total));
+}
+
+void decode_spill(const char* p, LogBackend::Item& item) {
+    LogRecord& rec = item.entry.record;
+    p += sizeof(std::uint32_t);
+    rec.level = static_cast<LoggerLevel>(get_raw<std::uint8_t>(p));
+    rec.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::system_clock::duration(get_raw<std::int64_t>(p)));
+    rec.threadId = get_raw<std::uint64_t>(p);
+    rec.thread = get_raw<const XZeroThread::Tag*>(p);
+    rec.file = get_raw<const char*>(p);
+    rec.line = get_raw<std::int32_t>(p);
+    rec.func = get_raw<const char*>(p);
+    rec.site = get_raw<const LogSite*>(p);
+    rec.errorCode = get_raw<std::int32_t>(p);
+    item.ticket = get_raw<LogBackend::DurableTicket*>(p);
+    rec.message = get_string(p);
+    rec.logger = get_string(p);
+    rec.fields = get_string(p);
+    const std::uint32_t mdc_count = get_raw<std::uint32_t>(p);
+    std::vector<XZeroMDC::Entry> mdc;
+    for (std::uint32_t i = 0; i < mdc_count; ++i) {
+        std::string key = get_string(p);
+        mdc.emplace_back(std::move(key), get_string(p));
+    }
+    rec.mdc = XZeroMDC::make_snapshot(std::move(mdc));
+}
+
+// 队列满时先自旋让出 CPU 的次数，之后挂起等待分发线程唤醒；兜底等待上限（毫秒）
+const int kSlotSpins = 64;
+const int kSlotWaitMs = 50;
+
+const char* overflow_policy_name(OverflowPolicy policy) {
+    switch (policy) {
+    case OverflowPolicy::Block:
+        return "Block";
+    case OverflowPolicy::DropNewest:
+        return "DropNewest";
+    case OverflowPolicy::DropOldest:
+        return "DropOldest";
+    case OverflowPolicy::Spill:
+        return "Spill";
+    }
+    return "Unknown";
+}
+
+} // namespace
+
+LogBackend::LogBackend(const LoggerConfig& cfg)
+    : config_(cfg), platform_(detect_platform()), formatter_(cfg, platform_) {
+    // 内置 sink：控制台在前、文件在后；传入的配置副本不再携带 sinks 列表
+    LoggerConfig builtin = config_;
+    builtin.sinks.clear();
+    if (config_.toConsole) {
+        std::shared_ptr<LogSink> console = std::make_shared<ConsoleSink>(builtin);
+        if (config_.asyncConsole) {
+            console = std::make_shared<AsyncSink>(console, config_.queueCapacity,
+                                                  config_.flushIntervalMs);
+        }
+        sinks_.push_back(console);
+    }
+    if (config_.toFile) {
+        // 路径校验、建目录与打开由文件 sink 完成，失败时抛出异常
+        // 同一路径在进程内只打开一次
+        sinks_.push_back(FileSink::open_shared(builtin));
+    }
+    for (const auto& sink : config_.sinks) {
+        if (sink) sinks_.push_back(sink);
+    }
+
+    // 汇总需要渲染的格式，并按是否自带写线程分组
+    for (const auto& sink : sinks_) {
+        if (sink->format() == LogFormat::HumanFriendly) need_human_ = true;
+        if (sink->format() == LogFormat::Json) need_json_ = true;
+        if (sink->owns_thread()) {
+            threaded_sinks_.push_back(sink.get());
+        } else {
+            direct_sinks_.push_back(sink.get());
+        }
+    }
+
+    // 崩溃保护：fd 在此预先打开，信号处理函数中只做 write
+    if (config_.crashHandler) {
+        const std::string path = crash_log_path(config_);
+        if (path.empty()) {
+            crash_fd_ = 2;
+        } else {
+            if (!ensure_parent_directories(path) || (crash_fd_ = open_append(path)) < 0) {
+                throw std::runtime_error("无法打开崩溃记录文件: " + path);
+            }
+            crash_fd_owned_ = true;
+        }
+        XZeroCrash::install();
+        XZeroCrash::register_backend(this);
+    }
+
+    next_stats_ = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(config_.statsIntervalMs);
+    last_sync_ = std::chrono::steady_clock::now();
+
+    // 启动异步分发线程：避免高频日志阻塞调用线程
+    if (config_.asyncLogging) {
+        if (config_.batchSize == 0) config_.batchSize = 1;
+        if (config_.overflowPolicy == OverflowPolicy::Spill) {
+            if (config_.spillPath.empty()) {
+                spill_file_ = std::tmpfile();
+            } else if (ensure_parent_directories(config_.spillPath)) {
+                spill_file_ = std::fopen(config_.spillPath.c_str(), "w+b");
+            }
+            if (!spill_file_) {
+                throw std::runtime_error("无法打开溢出文件: " +
+                                         (config_.spillPath.empty() ? std::string("<tmpfile>")
+                                                                    : config_.spillPath));
+            }
+        }
+        queue_.reset(new MpscQueue<Item>(config_.queueCapacity));
+        worker_ = std::thread(&LogBackend::worker_loop, this);
+    }
+}
+
+LogBackend::~LogBackend() {
+    if (config_.crashHandler) {
+        XZeroCrash::unregister_backend(this);
+    }
+    // 通知后台线程退出并 flush；sink 随后析构，写出各自剩余的缓冲
+    if (config_.asyncLogging) {
+        {
+            std::lock_guard<std::mutex> lk(wake_mutex_);
+            stop_.store(true, std::memory_order_release);
+        }
+        cv_.notify_one();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    } else {
+        // 异步模式由分发线程退出前补报与落盘
+        report_suppressed(true);
+        if (config_.durability != Durability::None && unsynced_) {
+            sync_sinks(std::chrono::steady_clock::now());
+        }
+    }
+    if (spill_file_) {
+        std::fclose(spill_file_);
+    }
+    if (crash_fd_owned_) {
+#if defined(_WIN32)
+        _close(crash_fd_);
+#else
+        ::close(crash_fd_);
+#endif
+    }
+}
+
+std::shared_ptr<LogBackend> LogBackend::acquire(const LoggerConfig& cfg) {
+    if (!cfg.sinks.empty() || (!cfg.toFile && !cfg.toConsole)) {
+        return std::make_shared<LogBackend>(cfg);
+    }
+    // 输出目标（规范化后的文件路径 + 是否输出控制台）+ 后端配置签名：
+    // 同一目标上配置不同的日志器各用一个后端，文件本身仍由 FileSink 按路径共享并校验
+    std::string key = cfg.toConsole ? "console|" : "|";
+    if (cfg.toFile) key += normalized_path(cfg.filePath);
+    key += '|';
+    key += backend_signature(cfg);
+
+    BackendRegistry& registry = backend_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::weak_ptr<LogBackend>& slot = registry.backends[key];
+    std::shared_ptr<LogBackend> backend = slot.lock();
+    if (!backend) {
+        backend = std::make_shared<LogBackend>(cfg);
+        slot = backend;
+    }
+    return backend;
+}
+
+void LogBackend::submit(Item&& item) const {
+    const bool durable = config_.durability == Durability::GroupCommit &&
+                         needs_durable(item.entry.record.level);
+    if (config_.asyncLogging) {
+        // 延迟格式化：交由分发线程渲染，否则在调用线程完成
+        if (!config_.deferredFormatting) {
+            render(item);
+        }
+        if (!durable) {
+            // 将日志放入无锁队列，后台线程批量分发
+            enqueue(std::move(item));
+            return;
+        }
+        // 组提交：票据随记录入队，分发线程写出并落盘整批后置位；同批的等待者共用一次落盘
+        DurableTicket ticket;
+        item.ticket = &ticket;
+        enqueue(std::move(item));
+        std::unique_lock<std::mutex> lk(durable_mutex_);
+        durable_cv_.wait(lk, [&ticket] { return ticket.done; });
+    } else {
+        // 同步路径，直接分发
+        sync_submitted_.fetch_add(1, std::memory_order_relaxed);
+        render(item);
+        std::uint64_t seq = 0;
+        {
+            std::lock_guard<std::mutex> lock(dispatch_mutex_);
+            const bool urgent = batch_urgent(&item, 1);
+            const auto start = std::chrono::steady_clock::now();
+            dispatch(&item, 1);
+            const auto end = std::chrono::steady_clock::now();
+            written_.fetch_add(1, std::memory_order_relaxed);
+            batch_size_.record(1);
+            batch_latency_ns_.record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+            commit(urgent, end);
+            seq = dispatched_seq_.fetch_add(1, std::memory_order_release) + 1;
+            maybe_emit_stats(end);
+            report_suppressed(false);
+        }
+        // 落盘在 dispatch_mutex_ 之外进行，其间其他线程可继续写入，随后由同一次落盘覆盖
+        if (durable) group_commit(seq);
+    }
+}
+
+LogStatsSnapshot LogBackend::stats() const {
+    LogStatsSnapshot s;
+    if (queue_) {
+        s.enqueued = queue_->pushed_total();
+        s.queue_depth = queue_->size_approx();
+        s.queue_capacity = queue_->capacity();
+    } else {
+        s.enqueued = sync_submitted_.load(std::memory_order_relaxed);
+    }
+    s.written = written_.load(std::memory_order_relaxed);
+    s.filtered = filtered_.load(std::memory_order_relaxed);
+    s.dropped = dropped_.load(std::memory_order_relaxed);
+    s.spilled = spilled_.load(std::memory_order_relaxed);
+    s.queue_high_water = queue_high_water_.load(std::memory_order_relaxed);
+    s.queue_full_waits = queue_full_waits_.load(std::memory_order_relaxed);
+    s.batch_size = batch_size_.snapshot();
+    s.batch_latency_ns = batch_latency_ns_.snapshot();
+    for (const auto& sink : sinks_) {
+        sink->collect_stats(s);
+    }
+    return s;
+}
+
+void LogBackend::maybe_emit_stats(std::chrono::steady_clock::time_point now) const {
+    if (config_.statsIntervalMs == 0 || now < next_stats_) return;
+    next_stats_ = now + std::chrono::milliseconds(config_.statsIntervalMs);
+
+    // 直接在当前线程渲染并分发，不经过队列（队列满时也能写出）
+    Item item;
+    LogRecord& rec = item.entry.record;
+    rec.level = LoggerLevel::INFO;
+    rec.timestamp = std::chrono::system_clock::now();
+    const XZeroThread::Tag& thread = XZeroThread::current();
+    rec.threadId = thread.id;
+    rec.thread = &thread;
+    rec.message = stats().to_json();
+    rec.logger = "xzero.stats";
+    render(item);
+    dispatch(&item, 1);
+}
+
+void LogBackend::drain(std::size_t timeout_ms) const {
+    if (queue_) {
+        // 分发线程进入休眠前已确认队列为空并写完手中的批次
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (!(sleeping_.load(std::memory_order_acquire) && queue_->empty() &&
+                 !spill_active_.load(std::memory_order_acquire)) &&
+               std::chrono::steady_clock::now() < deadline) {
+            wake_worker();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    for (const auto& sink : sinks_) {
+        if (config_.durability != Durability::None) {
+            sink->sync();
+        } else {
+            sink->flush_pending();
+        }
+    }
+}
+
+void LogBackend::emergency_drain(int signo) const {
+    if (crash_fd_ < 0) return;
+    if (queue_) {
+        // 先让分发线程停在安全点（循环开头或休眠中），避免抢救时记录被移出队列；
+        // 崩溃的正是分发线程时等待超时后照常抢救
+        frozen_.store(true);
+        for (int i = 0; i < 100 && !parked_.load() && !sleeping_.load(); ++i) {
+#if !defined(_WIN32)
+            struct timespec ts = {0, 1000 * 1000};
+            ::nanosleep(&ts, nullptr);
+#endif
+        }
+    }
+    // 先写出 sink 缓冲中的较早记录，再写分发线程手中的批次与队列
+    for (LogSink* sink : direct_sinks_) {
+        sink->emergency_flush();
+    }
+    XZeroCrash::write_str(crash_fd_, "==== XZeroLog 崩溃抢救开始：signal ");
+    XZeroCrash::write_uint(crash_fd_, static_cast<unsigned long long>(signo));
+    XZeroCrash::write_str(crash_fd_, "（写出中的批次可能与上文重复） ====\n");
+
+    std::size_t count = 0;
+    auto write_item = [&](const Item& item) {
+        if (item.formatted && !item.entry.human.empty()) {
+            XZeroCrash::write_all(crash_fd_, item.entry.human.data(), item.entry.human.size());
+            XZeroCrash::write_str(crash_fd_, "\n");
+        } else {
+            XZeroCrash::write_record(crash_fd_, item.entry.record);
+        }
+        ++count;
+    };
+    const Item* inflight = inflight_.load(std::memory_order_acquire);
+    if (inflight) {
+        const std::size_t n = inflight_count_.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < n; ++i) write_item(inflight[i]);
+    }
+    if (queue_) {
+        queue_->for_each_ready(write_item);
+    }
+
+    XZeroCrash::write_str(crash_fd_, "==== XZeroLog 崩溃抢救结束：共 ");
+    XZeroCrash::write_uint(crash_fd_, static_cast<unsigned long long>(count));
+    XZeroCrash::write_str(crash_fd_, " 条 ====\n");
+}
+
+void LogBackend::render(Item& item) const {
+    if (item.formatted) return;
+    if (need_human_) item.entry.human = formatter_.format(item.entry.record, LogFormat::HumanFriendly);
+    if (need_json_) item.entry.json = formatter_.format(item.entry.record, LogFormat::Json);
+    item.formatted = true;
+}
+
+void LogBackend::dispatch(Item* items, std::size_t n) const {
+    // 直接 sink：整批写入后 flush 一次；文件 sink 零拷贝引用文本，须在移交共享所有权之前完成
+    for (LogSink* sink : direct_sinks_) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (sink->accepts(items[i].entry.record.level)) {
+                sink->write(items[i].entry);
+            }
+        }
+        sink->flush();
+    }
+    if (threaded_sinks_.empty()) return;
+    // 自带写线程的 sink 共享同一份已渲染记录，不重复格式化也不逐个拷贝
+    for (std::size_t i = 0; i < n; ++i) {
+        std::shared_ptr<const LogEntry> shared;
+        for (LogSink* sink : threaded_sinks_) {
+            if (!sink->accepts(items[i].entry.record.level)) continue;
+            if (!shared) shared = std::make_shared<const LogEntry>(std::move(items[i].entry));
+            sink->post(shared);
+        }
+    }
+}
+
+bool LogBackend::needs_durable(LoggerLevel level) const {
+    return Logger::severity(level) >= Logger::severity(config_.durabilityLevel);
+}
+
+bool LogBackend::batch_urgent(const Item* items, std::size_t n) const {
+    switch (config_.durability) {
+    case Durability::OnError:
+        for (std::size_t i = 0; i < n; ++i) {
+            if (needs_durable(items[i].entry.record.level)) return true;
+        }
+        return false;
+    case Durability::GroupCommit:
+        for (std::size_t i = 0; i < n; ++i) {
+            if (items[i].ticket) return true;
+        }
+        return false;
+    case Durability::None:
+    case Durability::Interval:
+        break;
+    }
+    return false;
+}
+
+void LogBackend::commit(bool urgent, std::chrono::steady_clock::time_point now) const {
+    if (config_.durability == Durability::None) return;
+    unsynced_ = true;
+    if (urgent || (config_.durability == Durability::Interval &&
+                   now - last_sync_ >= std::chrono::milliseconds(config_.durabilityIntervalMs))) {
+        sync_sinks(now);
+    }
+}
+
+void LogBackend::sync_sinks(std::chrono::steady_clock::time_point now) const {
+    for (LogSink* sink : direct_sinks_) {
+        sink->sync();
+    }
+    last_sync_ = now;
+    unsynced_ = false;
+}
+
+void LogBackend::release_tickets(const Item* items, std::size_t n) const {
+    bool any = false;
+    {
+        std::lock_guard<std::mutex> lock(durable_mutex_);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (items[i].ticket) {
+                items[i].ticket->done = true;
+                any = true;
+            }
+        }
+    }
+    // 置位后等待者可能立即返回并销毁票据，此后不再访问
+    if (any) durable_cv_.notify_all();
+}
+
+void LogBackend::group_commit(std::uint64_t seq) const {
+    std::lock_guard<std::mutex> lock(commit_mutex_);
+    // 排队期间已有落盘覆盖了本条
+    if (durable_seq_ >= seq) return;
+    const std::uint64_t target = dispatched_seq_.load(std::memory_order_acquire);
+    for (LogSink* sink : direct_sinks_) {
+        sink->sync();
+    }
+    durable_seq_ = target;
+}
+
+void LogBackend::enqueue(Item&& item) const {
+    // 溢出文件中尚有未回放的记录时，新记录也写入文件，保证同一线程的记录不乱序
+    if (spill_file_ && spill_active_.load(std::memory_order_relaxed)) {
+        if (!spill(item)) {
+            if (item.ticket) {
+                // 须落盘的记录不丢弃：溢出文件写满时改为等待队列槽位
+                if (!queue_->try_push(std::move(item))) wait_for_slot(item);
+            } else {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    } else if (!queue_->try_push(std::move(item))) {
+        queue_full_waits_.fetch_add(1, std::memory_order_relaxed);
+        if (!wait_for_slot(item)) return;
+    }
+    // 与 worker_loop 中的 fence 配对：要么后台线程看到新数据，要么这里看到其休眠标记
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        wake_worker();
+    }
+}
+
+bool LogBackend::wait_for_slot(Item& item) const {
+    // 有调用线程在等待落盘的记录一律阻塞等待槽位，不丢弃、不溢出、不超时
+    const OverflowPolicy policy = item.ticket ? OverflowPolicy::Block : config_.overflowPolicy;
+    switch (policy) {
+    case OverflowPolicy::DropNewest:
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    case OverflowPolicy::Spill:
+        if (!spill(item)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true; // 需按休眠标记唤醒分发线程
+    case OverflowPolicy::DropOldest:
+        // 由分发线程丢弃最旧的非 ERROR 记录，这里只需等到腾出槽位
+        shed_.store(true, std::memory_order_relaxed);
+        break;
+    case OverflowPolicy::Block:
+        break;
+    }
+    // 先短暂让出 CPU 并催促后台线程（积压通常很快消化），仍满时挂起在 slot_cv_ 上，
+    // 由分发线程每取走一批后唤醒，磁盘卡顿期间被阻塞的生产者不再空转占满 CPU；Block 策略可设置超时
+    const bool timed = policy == OverflowPolicy::Block && !item.ticket && config_.blockTimeoutMs > 0;
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(config_.blockTimeoutMs);
+    for (int spin = 0; spin < kSlotSpins; ++spin) {
+        wake_worker();
+        std::this_thread::yield();
+        if (queue_->try_push(std::move(item))) return true;
+        if (timed && std::chrono::steady_clock::now() >= deadline) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    wake_worker();
+    std::unique_lock<std::mutex> lk(slot_mutex_);
+    slot_waiters_.fetch_add(1, std::memory_order_relaxed);
+    // 与 notify_slot_waiters 中的 fence 配对：要么这里的 try_push 看到腾出的槽位，要么分发线程看到等待者
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool pushed = false;
+    while (!(pushed = queue_->try_push(std::move(item)))) {
+        // 有上限的等待只作兜底，正常由分发线程唤醒
+        auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(kSlotWaitMs);
+        if (timed) {
+            if (std::chrono::steady_clock::now() >= deadline) break;
+            if (deadline < until) until = deadline;
+        }
+        slot_cv_.wait_until(lk, until);
+    }
+    slot_waiters_.fetch_sub(1, std::memory_order_relaxed);
+    if (!pushed) dropped_.fetch_add(1, std::memory_order_relaxed);
+    return pushed;
+}
+
+void LogBackend::notify_slot_waiters() const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (slot_waiters_.load(std::memory_order_relaxed) == 0) return;
+    // 持锁通知：等待者在持锁检查之后才进入等待，不会错过本次唤醒
+    std::lock_guard<std::mutex> lk(slot_mutex_);
+    slot_cv_.notify_all();
+}
+
+bool LogBackend::spill(const Item& item) const {
+    std::string encoded;
+    encode_spill(item, encoded);
+    std::lock_guard<std::mutex> lock(spill_mutex_);
+    if (config_.spillMaxBytes > 0 && spill_write_ + encoded.size() > config_.spillMaxBytes) {
+        return false;
+    }
+    if (std::fseek(spill_file_, static_cast<long>(spill_write_), SEEK_SET) != 0 ||
+        std::fwrite(encoded.data(), 1, encoded.size(), spill_file_) != encoded.size()) {
+        return false;
+    }
+    spill_write_ += encoded.size();
+    spilled_.fetch_add(1, std::memory_order_relaxed);
+    spill_active_.store(true, std::memory_order_release);
+    return true;
+}
+
+std::size_t LogBackend::replay_spill(std::vector<Item>& batch) {
+    std::lock_guard<std::mutex> lock(spill_mutex_);
+    std::size_t n = 0;
+    if (spill_read_ < spill_write_ &&
+        std::fseek(spill_file_, static_cast<long>(spill_read_), SEEK_SET) == 0) {
+        while (n < config_.batchSize && spill_read_ < spill_write_) {
+            std::uint32_t total = 0;
+            if (std::fread(&total, 1, sizeof(total), spill_file_) != sizeof(total) ||
+                total < sizeof(total)) {
+                break;
+            }
+            spill_buf_.resize(total);
+            std::memcpy(&spill_buf_[0], &total, sizeof(total));
+            if (std::fread(&spill_buf_[sizeof(total)], 1, total - sizeof(total), spill_file_) !=
+                total - sizeof(total)) {
+                break;
+            }
+            Item item;
+            decode_spill(spill_buf_.data(), item);
+            batch.push_back(std::move(item));
+            spill_read_ += total;
+            ++n;
+        }
+        if (n == 0) {
+            // 读取失败：放弃剩余内容，计为丢弃，避免反复重试
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            spill_read_ = spill_write_;
+        }
+    }
+    if (spill_read_ >= spill_write_) {
+        // 全部回放完毕：复用文件，从头写起
+        spill_read_ = 0;
+        spill_write_ = 0;
+        spill_active_.store(false, std::memory_order_release);
+    }
+    return n;
+}
+
+void LogBackend::shed_oldest(std::vector<Item>& batch) {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        // 有调用线程在等待落盘的记录同样保留
+        if (batch[i].entry.record.level == LoggerLevel::ERROR || batch[i].ticket) {
+            if (kept != i) batch[kept] = std::move(batch[i]);
+            ++kept;
+        }
+    }
+    dropped_.fetch_add(batch.size() - kept, std::memory_order_relaxed);
+    batch.resize(kept);
+    // 积压降到一半以下后恢复正常写出
+    if (queue_->size_approx() < queue_->capacity() / 2) {
+        shed_.store(false, std::memory_order_relaxed);
+    }
+}
+
+void LogBackend::report_drops(bool force) {
+    const std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped == reported_drops_) return;
+    const auto now = std::chrono::steady_clock::now();
+    if (!force && now < next_drop_report_) return;
+    next_drop_report_ = now + std::chrono::seconds(1);
+
+    Item item;
+    LogRecord& rec = item.entry.record;
+    rec.level = LoggerLevel::WARN;
+    rec.timestamp = std::chrono::system_clock::now();
+    const XZeroThread::Tag& thread = XZeroThread::current();
+    rec.threadId = thread.id;
+    rec.thread = &thread;
+    rec.message = std::string("背压：队列已满（策略 ") + overflow_policy_name(config_.overflowPolicy) +
+                  "），丢弃了 " + std::to_string(dropped - reported_drops_) + " 条日志（累计 " +
+                  std::to_string(dropped) + " 条）";
+    rec.logger = "xzero.backpressure";
+    reported_drops_ = dropped;
+    render(item);
+    dispatch(&item, 1);
+}
+
+void LogBackend::attach_recorder(FlightRecorder* recorder, const std::string& logger) {
+    std::lock_guard<std::mutex> lock(recorder_mutex_);
+    recorders_.push_back(std::make_pair(recorder, logger));
+}
+
+void LogBackend::detach_recorder(FlightRecorder* recorder) {
+    std::lock_guard<std::mutex> lock(recorder_mutex_);
+    for (auto it = recorders_.begin(); it != recorders_.end(); ++it) {
+        if (it->first == recorder) {
+            recorders_.erase(it);
+            return;
+        }
+    }
+}
+
+std::vector<LogBackend::Item> LogBackend::make_dump(std::vector<LogRecord>&& records,
+                                                    const std::string& logger) const {
+    std::vector<Item> items;
+    if (records.empty()) return items;
+    // 标记取被转储记录中最低的等级：与这些记录通过相同的 sink 过滤，也不会计入 ERROR 或触发落盘等待
+    LoggerLevel level = records.front().level;
+    for (const LogRecord& rec : records) {
+        if (Logger::severity(rec.level) < Logger::severity(level)) level = rec.level;
+    }
+    const std::size_t count = records.size();
+    auto marker = [&](const std::string& message) {
+        Item item;
+        LogRecord& rec = item.entry.record;
+        rec.level = level;
+        rec.timestamp = XZeroTime::now(config_.clockSource);
+        const XZeroThread::Tag& thread = XZeroThread::current();
+        rec.threadId = thread.id;
+        rec.thread = &thread;
+        rec.message = message;
+        rec.logger = logger;
+        return item;
+    };
+    items.reserve(count + 2);
+    // 留存记录保持原时间戳，前后以标记行包围
+    items.push_back(marker("---- 飞行记录器转储开始：" + std::to_string(count) + " 条 ----"));
+    for (LogRecord& rec : records) {
+        Item item;
+        item.entry.record = std::move(rec);
+        items.push_back(std::move(item));
+    }
+    items.push_back(marker("---- 飞行记录器转储结束 ----"));
+    return items;
+}
+
+std::size_t LogBackend::dump_recorder(FlightRecorder& recorder, const std::string& logger) const {
+    std::vector<Item> items = make_dump(recorder.drain(), logger);
+    for (Item& item : items) {
+        submit(std::move(item));
+    }
+    return items.empty() ? 0 : items.size() - 2;
+}
+
+void LogBackend::dump_requested_recorders() {
+    const unsigned generation = FlightRecorder::request_generation();
+    if (generation == seen_dump_generation_) return;
+    seen_dump_generation_ = generation;
+    // 持锁分发：日志器析构时的注销等待本次转储结束
+    std::lock_guard<std::mutex> lock(recorder_mutex_);
+    for (const auto& entry : recorders_) {
+        // 与日志器自身的检查竞争认领，同一请求只转储一次
+        if (!entry.first->acknowledge_request()) continue;
+        std::vector<Item> items = make_dump(entry.first->drain(), entry.second);
+        if (items.empty()) continue;
+        // 直接在分发线程上写出，不经过队列（队列满时也不会阻塞自己）
+        for (Item& item : items) render(item);
+        dispatch(items.data(), items.size());
+        written_.fetch_add(items.size(), std::memory_order_relaxed);
+    }
+}
+
+void LogBackend::defer_suppressed(XZeroRate::Suppression& suppression, const LogSite& site,
+                                  LoggerLevel level, const std::string& logger) const {
+    std::lock_guard<std::mutex> lock(suppress_mutex_);
+    for (const PendingSuppression& pending : suppressions_) {
+        if (pending.suppression == &suppression) return; // 上次登记尚未取走
+    }
+    PendingSuppression pending;
+    pending.suppression = &suppression;
+    pending.site = &site;
+    pending.level = level;
+    pending.logger = logger;
+    suppressions_.push_back(std::move(pending));
+}
+
+void LogBackend::report_suppressed(bool force) const {
+    const auto now = std::chrono::steady_clock::now();
+    if (!force && now < next_suppress_report_) return;
+    std::vector<PendingSuppression> pending;
+    {
+        std::lock_guard<std::mutex> lock(suppress_mutex_);
+        if (suppressions_.empty()) return;
+        pending.swap(suppressions_);
+    }
+    next_suppress_report_ = now + std::chrono::seconds(1);
+
+    // 取走后调用点解除登记，之后再抑制时重新登记；已由调用点放行时补报过的计数为 0，跳过
+    for (const PendingSuppression& p : pending) {
+        const std::uint64_t count = p.suppression->take();
+        if (count == 0) continue;
+        Item item;
+        LogRecord& rec = item.entry.record;
+        rec.level = p.level;
+        rec.timestamp = std::chrono::system_clock::now();
+        const XZeroThread::Tag& thread = XZeroThread::current();
+        rec.threadId = thread.id;
+        rec.thread = &thread;
+        rec.file = p.site->file;
+        rec.line = p.site->line;
+        rec.func = p.site->func;
+        rec.site = p.site;
+        XZeroFmt::ScopedBuffer buf;
+        XZeroFmt::format_to(buf.get(), p.suppression->summary(), count);
+        rec.message.assign(buf.get().data(), buf.get().size());
+        rec.logger = p.logger;
+        render(item);
+        dispatch(&item, 1);
+    }
+}
+
+void LogBackend::wake_worker() const {
+    std::lock_guard<std::mutex> lk(wake_mutex_);
+    cv_.notify_one();
+}
+
+void LogBackend::worker_loop() {
+    std::vector<Item> batch;
+    batch.reserve(config_.batchSize);
+    // 非逐批 flush 时，等待时长不超过 flushTimeIntervalMs，以便空闲时兜底写出
+    std::size_t wait_ms = config_.flushIntervalMs;
+    if (config_.flushPolicy != FlushPolicy::EveryBatch && config_.flushTimeIntervalMs < wait_ms) {
+        wait_ms = config_.flushTimeIntervalMs;
+    }
+    if (config_.statsIntervalMs > 0 && config_.statsIntervalMs < wait_ms) {
+        wait_ms = config_.statsIntervalMs;
+    }
+    if (config_.durability == Durability::Interval && config_.durabilityIntervalMs < wait_ms) {
+        wait_ms = config_.durabilityIntervalMs;
+    }
+    const auto wait_duration = std::chrono::milliseconds(wait_ms > 0 ? wait_ms : 1);
+
+    auto write_batch = [&] {
+        const auto start = std::chrono::steady_clock::now();
+        // 延迟格式化的记录在分发线程上渲染
+        for (auto& item : batch) {
+            render(item);
+        }
+        // 各 sink 引用 batch 中的文本，须在 clear 之前完成 flush
+        if (crash_fd_ >= 0) {
+            inflight_count_.store(batch.size(), std::memory_order_relaxed);
+            inflight_.store(batch.data(), std::memory_order_release);
+        }
+        const bool urgent = batch_urgent(batch.data(), batch.size());
+        dispatch(batch.data(), batch.size());
+        if (crash_fd_ >= 0) {
+            inflight_.store(nullptr, std::memory_order_release);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        written_.fetch_add(batch.size(), std::memory_order_relaxed);
+        batch_size_.record(batch.size());
+        batch_latency_ns_.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        // 整批一次落盘（耗时计入 fsync_latency_ns，不计入批次耗时），再唤醒本批的等待者
+        commit(urgent, end);
+        if (urgent) release_tickets(batch.data(), batch.size());
+        batch.clear();
+        maybe_emit_stats(end);
+    };
+
+    while (true) {
+        if (crash_fd_ >= 0 && frozen_.load()) {
+            // 信号处理函数正在抢救：不再触碰队列与 sink，等待进程终止
+            parked_.store(true);
+            while (true) std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+        // 批量出队，每批最多 batchSize 条
+        queue_->pop_bulk(std::back_inserter(batch), config_.batchSize);
+        if (!batch.empty()) {
+            // 已腾出槽位：唤醒挂起的生产者，再写出本批
+            notify_slot_waiters();
+            // 出队后的剩余量是近似值，上限取队列容量
+            std::uint64_t depth = batch.size() + queue_->size_approx();
+            if (depth > queue_->capacity()) depth = queue_->capacity();
+            if (depth > queue_high_water_.load(std::memory_order_relaxed)) {
+                queue_high_water_.store(depth, std::memory_order_relaxed);
+            }
+            if (shed_.load(std::memory_order_relaxed)) {
+                shed_oldest(batch);
+            }
+            if (!batch.empty()) {
+                write_batch();
+            }
+            report_drops(false);
+            report_suppressed(false);
+            dump_requested_recorders();
+            continue;
+        }
+
+        // 队列已追上：按序回放溢出文件中的记录
+        if (spill_file_ && spill_active_.load(std::memory_order_acquire)) {
+            if (replay_spill(batch) > 0) {
+                write_batch();
+            }
+            continue;
+        }
+
+        if (stop_.load(std::memory_order_acquire)) {
+            // 析构时已无生产者，flush 剩余（含溢出文件）后退出
+            while (queue_->pop_bulk(std::back_inserter(batch), config_.batchSize) > 0) {
+                write_batch();
+            }
+            while (spill_file_ && replay_spill(batch) > 0) {
+                write_batch();
+            }
+            report_drops(true);
+            report_suppressed(true);
+            if (unsynced_) sync_sinks(std::chrono::steady_clock::now());
+            break;
+        }
+
+        report_drops(false);
+        report_suppressed(false);
+        dump_requested_recorders();
+
+        for (LogSink* sink : direct_sinks_) {
+            sink->on_idle();
+        }
+        if (unsynced_) {
+            // Interval：空闲时兜底，最后写出的记录同样在间隔内落盘
+            commit(false, std::chrono::steady_clock::now());
+        }
+        maybe_emit_stats(std::chrono::steady_clock::now());
+
+        // 队列为空：标记休眠后再确认一次，避免丢失唤醒
+        std::unique_lock<std::mutex> lk(wake_mutex_);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_->empty() && !spill_active_.load(std::memory_order_acquire) &&
+            !stop_.load(std::memory_order_acquire)) {
+            cv_.wait_for(lk, wait_duration);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
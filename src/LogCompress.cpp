@@ -0,0 +1,329 @@
+#include "LogCompress.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(XZEROLOG_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace {
+
+const char kMagic[4] = {'X', 'Z', 'L', 'Z'};
+const std::uint8_t kVersion = 1;
+
+const int kHashLog = 14;
+const std::size_t kMinMatch = 4;
+const std::size_t kLastLiterals = 5; // 块末尾至少保留的字面量字节
+const std::size_t kMfLimit = 12;     // 最后一个匹配须在距末尾 12 字节之前开始
+const std::size_t kMaxOffset = 65535;
+
+std::uint32_t read32(const std::uint8_t* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+std::uint32_t hash4(std::uint32_t v) {
+    return (v * 2654435761U) >> (32 - kHashLog);
+}
+
+// 长度超过 15 的部分以 255 序列延续
+std::uint8_t* put_length(std::uint8_t* op, std::size_t len) {
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = static_cast<std::uint8_t>(len);
+    return op;
+}
+
+std::uint8_t* put_literals(std::uint8_t* op, std::uint8_t token_match, const std::uint8_t* lit,
+                           std::size_t lit_len) {
+    std::uint8_t* token = op++;
+    *token = static_cast<std::uint8_t>((lit_len >= 15 ? 15 : lit_len) << 4) | token_match;
+    if (lit_len >= 15) op = put_length(op, lit_len - 15);
+    std::memcpy(op, lit, lit_len);
+    return op + lit_len;
+}
+
+void put_u32(std::string& out, std::uint32_t v) {
+    char b[4] = {static_cast<char>(v), static_cast<char>(v >> 8), static_cast<char>(v >> 16),
+                 static_cast<char>(v >> 24)};
+    out.append(b, 4);
+}
+
+bool get_u32(const std::string& data, std::size_t& pos, std::uint32_t& v) {
+    if (data.size() - pos < 4) return false;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data() + pos);
+    v = static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+        (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+    pos += 4;
+    return true;
+}
+
+bool write_all(std::FILE* f, const char* data, std::size_t n) {
+    return std::fwrite(data, 1, n, f) == n;
+}
+
+bool compress_xzlz(std::FILE* in, std::FILE* out) {
+    std::vector<char> raw(XZeroCompress::kBlockSize);
+    std::vector<char> packed(XZeroCompress::lz4_bound(XZeroCompress::kBlockSize));
+    std::string header(kMagic, sizeof(kMagic));
+    header.push_back(static_cast<char>(kVersion));
+    if (!write_all(out, header.data(), header.size())) return false;
+
+    std::string block_header;
+    while (true) {
+        const std::size_t n = std::fread(raw.data(), 1, raw.size(), in);
+        if (n == 0) break;
+        std::size_t stored = XZeroCompress::lz4_compress_block(raw.data(), n, packed.data());
+        const char* payload = packed.data();
+        if (stored >= n) {
+            // 不可压缩的块原样存储
+            stored = n;
+            payload = raw.data();
+        }
+        block_header.clear();
+        put_u32(block_header, static_cast<std::uint32_t>(n));
+        put_u32(block_header, static_cast<std::uint32_t>(stored));
+        if (!write_all(out, block_header.data(), block_header.size()) ||
+            !write_all(out, payload, stored)) {
+            return false;
+        }
+    }
+    if (std::ferror(in)) return false;
+    block_header.clear();
+    put_u32(block_header, 0);
+    return write_all(out, block_header.data(), block_header.size());
+}
+
+bool decompress_xzlz(const std::string& data, std::string& out) {
+    std::size_t pos = sizeof(kMagic);
+    if (data.size() <= pos || static_cast<std::uint8_t>(data[pos]) != kVersion) return false;
+    ++pos;
+    while (true) {
+        std::uint32_t raw_len = 0;
+        std::uint32_t stored = 0;
+        if (!get_u32(data, pos, raw_len)) return false;
+        if (raw_len == 0) return true;
+        if (raw_len > XZeroCompress::kBlockSize || !get_u32(data, pos, stored) ||
+            stored > raw_len || data.size() - pos < stored) {
+            return false;
+        }
+        const std::size_t base = out.size();
+        if (stored == raw_len) {
+            out.append(data, pos, stored);
+        } else {
+            out.resize(base + raw_len);
+            if (!XZeroCompress::lz4_decompress_block(data.data() + pos, stored, &out[base],
+                                                     raw_len)) {
+                return false;
+            }
+        }
+        pos += stored;
+    }
+}
+
+#if defined(XZEROLOG_HAVE_ZLIB)
+bool compress_gzip(std::FILE* in, const std::string& dst) {
+    gzFile gz = gzopen(dst.c_str(), "wb6");
+    if (!gz) return false;
+    std::vector<char> buf(256 * 1024);
+    bool ok = true;
+    while (ok) {
+        const std::size_t n = std::fread(buf.data(), 1, buf.size(), in);
+        if (n == 0) break;
+        ok = gzwrite(gz, buf.data(), static_cast<unsigned>(n)) == static_cast<int>(n);
+    }
+    if (std::ferror(in)) ok = false;
+    return gzclose(gz) == Z_OK && ok;
+}
+
+bool decompress_gzip(const std::string& data, std::string& out) {
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) return false;
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in = static_cast<uInt>(data.size());
+    char buf[64 * 1024];
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        zs.next_out = reinterpret_cast<Bytef*>(buf);
+        zs.avail_out = sizeof(buf);
+        ret = inflate(&zs, Z_NO_FLUSH);
+        out.append(buf, sizeof(buf) - zs.avail_out);
+        // 多成员 gzip（例如追加拼接）继续解压下一成员
+        if (ret == Z_STREAM_END && zs.avail_in > 0) ret = inflateReset(&zs);
+    }
+    inflateEnd(&zs);
+    return ret == Z_STREAM_END;
+}
+#endif
+
+bool is_gzip(const std::string& data) {
+    return data.size() >= 2 && static_cast<unsigned char>(data[0]) == 0x1F &&
+           static_cast<unsigned char>(data[1]) == 0x8B;
+}
+
+} // namespace
+
+namespace XZeroCompress {
+
+BackupCompression effective(BackupCompression kind) {
+#if !defined(XZEROLOG_HAVE_ZLIB)
+    if (kind == BackupCompression::Gzip) return BackupCompression::Lz4;
+#endif
+    return kind;
+}
+
+const char* extension(BackupCompression kind) {
+    switch (effective(kind)) {
+    case BackupCompression::Lz4: return ".xzlz";
+    case BackupCompression::Gzip: return ".gz";
+    default: return "";
+    }
+}
+
+bool compress_file(const std::string& src, const std::string& dst, BackupCompression kind) {
+    kind = effective(kind);
+    if (kind == BackupCompression::None) return false;
+    std::FILE* in = std::fopen(src.c_str(), "rb");
+    if (!in) return false;
+
+    bool ok = false;
+#if defined(XZEROLOG_HAVE_ZLIB)
+    if (kind == BackupCompression::Gzip) {
+        ok = compress_gzip(in, dst);
+    } else
+#endif
+    {
+        std::FILE* out = std::fopen(dst.c_str(), "wb");
+        if (out) {
+            ok = compress_xzlz(in, out);
+            ok = std::fclose(out) == 0 && ok;
+        }
+    }
+    std::fclose(in);
+    if (!ok) std::remove(dst.c_str());
+    return ok;
+}
+
+bool looks_compressed(const std::string& data) {
+    return (data.size() >= sizeof(kMagic) &&
+            std::memcmp(data.data(), kMagic, sizeof(kMagic)) == 0) ||
+           is_gzip(data);
+}
+
+bool decompress(const std::string& data, std::string& out) {
+    out.clear();
+    if (data.size() >= sizeof(kMagic) && std::memcmp(data.data(), kMagic, sizeof(kMagic)) == 0) {
+        return decompress_xzlz(data, out);
+    }
+#if defined(XZEROLOG_HAVE_ZLIB)
+    if (is_gzip(data)) return decompress_gzip(data, out);
+#endif
+    return false;
+}
+
+std::size_t lz4_bound(std::size_t n) {
+    return n + n / 255 + 16;
+}
+
+std::size_t lz4_compress_block(const char* src, std::size_t n, char* dst) {
+    const std::uint8_t* in = reinterpret_cast<const std::uint8_t*>(src);
+    std::uint8_t* op = reinterpret_cast<std::uint8_t*>(dst);
+    std::size_t anchor = 0;
+
+    if (n > kMfLimit) {
+        // 表项存 位置+1，0 表示空
+        std::vector<std::uint32_t> table(static_cast<std::size_t>(1) << kHashLog, 0);
+        const std::size_t mf_limit = n - kMfLimit;
+        const std::size_t match_limit = n - kLastLiterals;
+        std::size_t ip = 0;
+        while (ip < mf_limit) {
+            const std::uint32_t seq = read32(in + ip);
+            const std::uint32_t h = hash4(seq);
+            const std::size_t ref_plus1 = table[h];
+            table[h] = static_cast<std::uint32_t>(ip + 1);
+            if (ref_plus1 != 0) {
+                std::size_t ref = ref_plus1 - 1;
+                if (ip - ref <= kMaxOffset && read32(in + ref) == seq) {
+                    std::size_t len = kMinMatch;
+                    while (ip + len < match_limit && in[ref + len] == in[ip + len]) ++len;
+                    // 向前扩展匹配，吞掉与之相同的字面量
+                    while (ip > anchor && ref > 0 && in[ip - 1] == in[ref - 1]) {
+                        --ip;
+                        --ref;
+                        ++len;
+                    }
+                    const std::size_t match_code = len - kMinMatch;
+                    op = put_literals(op, static_cast<std::uint8_t>(match_code >= 15 ? 15 : match_code),
+                                      in + anchor, ip - anchor);
+                    const std::size_t offset = ip - ref;
+                    *op++ = static_cast<std::uint8_t>(offset);
+                    *op++ = static_cast<std::uint8_t>(offset >> 8);
+                    if (match_code >= 15) op = put_length(op, match_code - 15);
+                    ip += len;
+                    anchor = ip;
+                    continue;
+                }
+            }
+            // 连续未命中时加大步长，快速跳过不可压缩数据
+            ip += 1 + ((ip - anchor) >> 6);
+        }
+    }
+    // 最后一段只有字面量
+    op = put_literals(op, 0, in + anchor, n - anchor);
+    return static_cast<std::size_t>(op - reinterpret_cast<std::uint8_t*>(dst));
+}
+
+bool lz4_decompress_block(const char* src, std::size_t n, char* dst, std::size_t raw_len) {
+    const std::uint8_t* in = reinterpret_cast<const std::uint8_t*>(src);
+    std::uint8_t* out = reinterpret_cast<std::uint8_t*>(dst);
+    std::size_t ip = 0;
+    std::size_t op = 0;
+    while (ip < n) {
+        const std::uint8_t token = in[ip++];
+        std::size_t lit = token >> 4;
+        if (lit == 15) {
+            std::uint8_t b;
+            do {
+                if (ip >= n) return false;
+                b = in[ip++];
+                lit += b;
+            } while (b == 255);
+        }
+        if (lit > n - ip || lit > raw_len - op) return false;
+        std::memcpy(out + op, in + ip, lit);
+        ip += lit;
+        op += lit;
+        if (ip == n) return op == raw_len; // 末尾序列无匹配部分
+
+        if (n - ip < 2) return false;
+        const std::size_t offset = static_cast<std::size_t>(in[ip]) |
+                                   (static_cast<std::size_t>(in[ip + 1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return false;
+        std::size_t len = token & 0x0F;
+        if (len == 15) {
+            std::uint8_t b;
+            do {
+                if (ip >= n) return false;
+                b = in[ip++];
+                len += b;
+            } while (b == 255);
+        }
+        len += kMinMatch;
+        if (len > raw_len - op) return false;
+        // 允许重叠（offset < len 时为重复模式），逐字节复制
+        const std::uint8_t* match = out + op - offset;
+        for (std::size_t i = 0; i < len; ++i) out[op + i] = match[i];
+        op += len;
+    }
+    return false;
+}
+
+} // namespace XZeroCompress
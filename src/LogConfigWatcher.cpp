@@ -0,0 +1,269 @@
+#include "LogConfigWatcher.h"
+
+#include "FileLogger.h"
+#include "LoggerRegistry.h"
+
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string trim(const std::string& s) {
+    std::size_t b = 0;
+    std::size_t e = s.size();
+    while (b < e && std::isspace(static_cast<unsigned char>(s[b]))) ++b;
+    while (e > b && std::isspace(static_cast<unsigned char>(s[e - 1]))) --e;
+    return s.substr(b, e - b);
+}
+
+std::string to_upper(std::string s) {
+    for (char& c : s) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    return s;
+}
+
+// 等级名 -> 等级掩码；OFF 为 0
+bool parse_level(const std::string& value, unsigned& mask) {
+    const std::string v = to_upper(value);
+    if (v == "OFF") {
+        mask = 0;
+    } else if (v == "DEBUG") {
+        mask = Logger::mask_at_least(LoggerLevel::DEBUG);
+    } else if (v == "INFO") {
+        mask = Logger::mask_at_least(LoggerLevel::INFO);
+    } else if (v == "WARN" || v == "WARNING") {
+        mask = Logger::mask_at_least(LoggerLevel::WARN);
+    } else if (v == "ERROR") {
+        mask = Logger::mask_at_least(LoggerLevel::ERROR);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parse_bool(const std::string& value, bool& out) {
+    const std::string v = to_upper(value);
+    if (v == "TRUE" || v == "ON" || v == "1" || v == "YES") {
+        out = true;
+    } else if (v == "FALSE" || v == "OFF" || v == "0" || v == "NO") {
+        out = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parse_flag(const std::string& name, LogFormatter::FormatFlag& flag) {
+    if (name == "time") flag = LogFormatter::kFormatTime;
+    else if (name == "platform") flag = LogFormatter::kFormatPlatform;
+    else if (name == "source") flag = LogFormatter::kFormatSource;
+    else if (name == "mdc") flag = LogFormatter::kFormatMdc;
+    else if (name == "error_code") flag = LogFormatter::kFormatErrorCode;
+    else return false;
+    return true;
+}
+
+struct LevelSetting {
+    std::string name; // 空表示根
+    unsigned mask;
+};
+
+struct FlagSetting {
+    LogFormatter::FormatFlag flag;
+    bool enabled;
+};
+
+bool read_file(const std::string& path, std::string& text) {
+    std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+    if (!in) return false;
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    text = ss.str();
+    return true;
+}
+
+} // namespace
+
+LogConfigWatcher::LogConfigWatcher(const std::string& path, Logger* target, std::size_t poll_ms)
+    : path_(path), target_(target), poll_ms_(poll_ms == 0 ? 1 : poll_ms) {
+    // 先建立监视再做首次加载，两者之间的修改不会丢失
+    open_inotify();
+    reload();
+    worker_ = std::thread(&LogConfigWatcher::run, this);
+}
+
+LogConfigWatcher::~LogConfigWatcher() {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+#if defined(__linux__)
+    if (wake_fds_[1] >= 0) {
+        const char c = 0;
+        (void)!::write(wake_fds_[1], &c, 1);
+    }
+#endif
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+#if defined(__linux__)
+    if (inotify_fd_ >= 0) ::close(inotify_fd_);
+    if (wake_fds_[0] >= 0) ::close(wake_fds_[0]);
+    if (wake_fds_[1] >= 0) ::close(wake_fds_[1]);
+#endif
+}
+
+bool LogConfigWatcher::reload() {
+    std::string text;
+    if (!read_file(path_, text)) {
+        return false;
+    }
+    if (!apply(text, target_)) {
+        return false;
+    }
+    reload_count_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool LogConfigWatcher::apply(const std::string& text, Logger* target, std::string* error) {
+    std::vector<LevelSetting> levels;
+    std::vector<FlagSetting> flags;
+
+    // 先完整解析，全部有效后再应用，避免半份配置生效
+    std::istringstream in(text);
+    std::string line;
+    std::size_t lineno = 0;
+    while (std::getline(in, line)) {
+        ++lineno;
+        const std::size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        const std::size_t eq = line.find('=');
+        const std::string key = eq == std::string::npos ? line : trim(line.substr(0, eq));
+        const std::string value = eq == std::string::npos ? std::string() : trim(line.substr(eq + 1));
+        bool ok = eq != std::string::npos;
+        if (ok && key == "level") {
+            LevelSetting s{std::string(), 0};
+            ok = parse_level(value, s.mask);
+            if (ok) levels.push_back(s);
+        } else if (ok && key.compare(0, 6, "level.") == 0 && key.size() > 6) {
+            LevelSetting s{key.substr(6), 0};
+            ok = parse_level(value, s.mask);
+            if (ok) levels.push_back(s);
+        } else if (ok && key.compare(0, 7, "format.") == 0) {
+            FlagSetting s{LogFormatter::kFormatTime, false};
+            ok = parse_flag(key.substr(7), s.flag) && parse_bool(value, s.enabled);
+            if (ok) flags.push_back(s);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            if (error) *error = "第 " + std::to_string(lineno) + " 行无效: " + line;
+            return false;
+        }
+    }
+
+    if (target) {
+        // 单个日志器：只认根等级，命名子树的设置忽略
+        for (const LevelSetting& s : levels) {
+            if (s.name.empty()) target->set_level_mask(s.mask);
+        }
+        if (FileLogger* file_logger = dynamic_cast<FileLogger*>(target)) {
+            for (const FlagSetting& s : flags) file_logger->set_format_flag(s.flag, s.enabled);
+        }
+    } else {
+        LoggerRegistry& registry = LoggerRegistry::instance();
+        // 按出现顺序应用：根在前、子树在后时子树的设置保留
+        for (const LevelSetting& s : levels) registry.set_level_mask(s.name, s.mask);
+        for (const FlagSetting& s : flags) registry.set_format_flag(s.flag, s.enabled);
+    }
+    return true;
+}
+
+void LogConfigWatcher::open_inotify() {
+#if defined(__linux__)
+    const int fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) return;
+    const std::size_t slash = path_.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path_.substr(0, slash));
+    // 监视目录而非文件本身：文件被 rename 替换后 inode 变化，对文件的监视会失效
+    // 唤醒管道用于析构时让 poll 返回
+    if (::inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0 ||
+        ::pipe2(wake_fds_, O_CLOEXEC) != 0) {
+        wake_fds_[0] = wake_fds_[1] = -1;
+        ::close(fd);
+        return;
+    }
+    inotify_fd_ = fd;
+#endif
+}
+
+void LogConfigWatcher::run() {
+    if (inotify_fd_ >= 0) {
+        watch_inotify();
+    } else {
+        watch_polling();
+    }
+}
+
+void LogConfigWatcher::watch_inotify() {
+#if defined(__linux__)
+    const std::size_t slash = path_.find_last_of('/');
+    const std::string base = slash == std::string::npos ? path_ : path_.substr(slash + 1);
+
+    alignas(struct inotify_event) char buf[4096];
+    for (;;) {
+        struct pollfd fds[2];
+        fds[0].fd = inotify_fd_;
+        fds[0].events = POLLIN;
+        fds[1].fd = wake_fds_[0];
+        fds[1].events = POLLIN;
+        if (::poll(fds, 2, -1) < 0) continue;
+        if (fds[1].revents != 0) break;
+
+        bool changed = false;
+        ssize_t n;
+        while ((n = ::read(inotify_fd_, buf, sizeof(buf))) > 0) {
+            for (char* p = buf; p < buf + n;) {
+                const struct inotify_event* ev = reinterpret_cast<const struct inotify_event*>(p);
+                if (ev->len > 0 && base == ev->name) changed = true;
+                p += sizeof(struct inotify_event) + ev->len;
+            }
+        }
+        if (changed) reload();
+    }
+#endif
+}
+
+void LogConfigWatcher::watch_polling() {
+    struct stat last;
+    bool have_last = ::stat(path_.c_str(), &last) == 0;
+    std::unique_lock<std::mutex> lk(mutex_);
+    while (!stop_) {
+        cv_.wait_for(lk, std::chrono::milliseconds(poll_ms_));
+        if (stop_) break;
+        struct stat st;
+        const bool have = ::stat(path_.c_str(), &st) == 0;
+        if (have && (!have_last || st.st_mtime != last.st_mtime || st.st_size != last.st_size)) {
+            lk.unlock();
+            reload();
+            lk.lock();
+        }
+        have_last = have;
+        if (have) last = st;
+    }
+}
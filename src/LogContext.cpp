@@ -1,28 +1,135 @@
 #include "LogContext.h"
 
-#include <mutex>
+#include "JsonEscape.h"
+
+#include <cstdint>
 
 namespace {
-thread_local std::unordered_map<std::string, std::string> tl_mdc;
+
+const std::size_t kInlineKeys = 8; // 预留容量：常见请求上下文不超过该数目，不再扩容
+
+struct ThreadContext {
+    ThreadContext() { entries.reserve(kInlineKeys); }
+
+    std::vector<XZeroMDC::Entry> entries;
+    std::uint64_t version{0};       // 每次修改递增
+    std::uint64_t cached_version{0};
+    XZeroMDC::SnapshotPtr cached;   // 与 cached_version 对应的快照
+};
+
+thread_local ThreadContext tl_mdc;
+
+XZeroMDC::Entry* find(const std::string& key) {
+    for (auto& entry : tl_mdc.entries) {
+        if (entry.first == key) return &entry;
+    }
+    return nullptr;
+}
+
+void erase(const std::string& key) {
+    auto& entries = tl_mdc.entries;
+    // 末尾元素（Scope 嵌套的常见情况）直接弹出；其他位置前移以保持插入顺序
+    if (!entries.empty() && entries.back().first == key) {
+        entries.pop_back();
+        ++tl_mdc.version;
+        return;
+    }
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->first == key) {
+            entries.erase(it);
+            ++tl_mdc.version;
+            return;
+        }
+    }
+}
+
+void append_json_string(std::string& out, const std::string& s) {
+    out.push_back('"');
+    XZeroJson::escape_append(out, s);
+    out.push_back('"');
+}
+
+} // namespace
+
+XZeroMDC::SnapshotPtr XZeroMDC::make_snapshot(std::vector<Entry> entries) {
+    if (entries.empty()) return SnapshotPtr();
+    std::shared_ptr<Snapshot> snap = std::make_shared<Snapshot>();
+    snap->entries = std::move(entries);
+    snap->human = " [CTX:";
+    snap->json = ",\"context\":{";
+    bool first = true;
+    for (const auto& kv : snap->entries) {
+        if (!first) {
+            snap->human.push_back(' ');
+            snap->json.push_back(',');
+        }
+        snap->human.append(kv.first);
+        snap->human.push_back('=');
+        snap->human.append(kv.second);
+        append_json_string(snap->json, kv.first);
+        snap->json.push_back(':');
+        append_json_string(snap->json, kv.second);
+        first = false;
+    }
+    snap->human.push_back(']');
+    snap->json.push_back('}');
+    return snap;
 }
 
 void XZeroMDC::put(const std::string& key, const std::string& value) {
-    tl_mdc[key] = value;
+    Entry* entry = find(key);
+    if (!entry) {
+        tl_mdc.entries.emplace_back(key, value);
+    } else if (entry->second != value) {
+        entry->second = value;
+    } else {
+        return; // 未变化，保留缓存的快照
+    }
+    ++tl_mdc.version;
 }
 
 void XZeroMDC::remove(const std::string& key) {
-    tl_mdc.erase(key);
+    erase(key);
 }
 
 void XZeroMDC::clear() {
-    tl_mdc.clear();
+    if (tl_mdc.entries.empty()) return;
+    tl_mdc.entries.clear();
+    ++tl_mdc.version;
 }
 
 std::string XZeroMDC::get(const std::string& key) {
-    auto it = tl_mdc.find(key);
-    return it == tl_mdc.end() ? std::string{} : it->second;
+    const Entry* entry = find(key);
+    return entry ? entry->second : std::string{};
 }
 
 std::unordered_map<std::string, std::string> XZeroMDC::all() {
-    return tl_mdc;
+    return std::unordered_map<std::string, std::string>(tl_mdc.entries.begin(),
+                                                        tl_mdc.entries.end());
+}
+
+XZeroMDC::SnapshotPtr XZeroMDC::snapshot() {
+    ThreadContext& ctx = tl_mdc;
+    if (ctx.cached_version != ctx.version) {
+        ctx.cached = make_snapshot(ctx.entries);
+        ctx.cached_version = ctx.version;
+    }
+    return ctx.cached;
+}
+
+XZeroMDC::Scope::Scope(const std::string& key, const std::string& value) : key_(key) {
+    const Entry* entry = find(key);
+    if (entry) {
+        had_previous_ = true;
+        previous_ = entry->second;
+    }
+    put(key, value);
+}
+
+XZeroMDC::Scope::~Scope() {
+    if (had_previous_) {
+        put(key_, previous_);
+    } else {
+        erase(key_);
+    }
 }
@@ -0,0 +1,271 @@
+#include "LogCrash.h"
+
+#include "LogBackend.h"
+#include "LogThread.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const std::size_t kMaxBackends = 64;
+const int kFatalSignals[] = {
+    SIGSEGV, SIGABRT, SIGFPE, SIGILL,
+#if !defined(_WIN32)
+    SIGBUS,
+#endif
+};
+const std::size_t kNumSignals = sizeof(kFatalSignals) / sizeof(kFatalSignals[0]);
+
+// 静态存储期、常量初始化：信号处理函数中访问无需构造保护
+std::atomic<LogBackend*> g_backends[kMaxBackends];
+std::atomic<int> g_state{0}; // 0 空闲 / 1 正在抢救 / 2 已完成
+
+#if !defined(_WIN32)
+struct sigaction g_previous[kNumSignals];
+char g_alt_stack[64 * 1024]; // 栈溢出导致的 SIGSEGV 需要备用栈才能运行处理函数
+#else
+void (*g_previous[kNumSignals])(int);
+#endif
+
+void drain_all(int signo) {
+    for (std::size_t i = 0; i < kMaxBackends; ++i) {
+        LogBackend* backend = g_backends[i].load(std::memory_order_acquire);
+        if (backend) backend->emergency_drain(signo);
+    }
+}
+
+void restore_and_raise(int signo) {
+    for (std::size_t i = 0; i < kNumSignals; ++i) {
+        if (kFatalSignals[i] != signo) continue;
+#if !defined(_WIN32)
+        ::sigaction(signo, &g_previous[i], nullptr);
+#else
+        std::signal(signo, g_previous[i] ? g_previous[i] : SIG_DFL);
+#endif
+    }
+    std::raise(signo);
+}
+
+extern "C" void xzero_fatal_signal(int signo) {
+    int expected = 0;
+    if (g_state.compare_exchange_strong(expected, 1)) {
+        drain_all(signo);
+        g_state.store(2);
+    } else {
+        // 其他线程正在抢救：稍候片刻再终止，尽量让其写完
+#if !defined(_WIN32)
+        for (int i = 0; i < 200 && g_state.load() == 1; ++i) {
+            struct timespec ts = {0, 5 * 1000 * 1000};
+            ::nanosleep(&ts, nullptr);
+        }
+#endif
+    }
+    restore_and_raise(signo);
+}
+
+// 正常退出路径：等待各后端写空，不依赖析构顺序
+void drain_at_exit() {
+    for (std::size_t i = 0; i < kMaxBackends; ++i) {
+        LogBackend* backend = g_backends[i].load(std::memory_order_acquire);
+        if (backend) backend->drain(1000);
+    }
+}
+
+void format_2(char* out, unsigned v) {
+    out[0] = static_cast<char>('0' + v / 10 % 10);
+    out[1] = static_cast<char>('0' + v % 10);
+}
+
+const char* level_name(LoggerLevel level) {
+    switch (level) {
+    case LoggerLevel::DEBUG:
+        return "DEBUG ";
+    case LoggerLevel::INFO:
+        return "INFO  ";
+    case LoggerLevel::WARN:
+        return "WARN  ";
+    case LoggerLevel::ERROR:
+        return "ERROR ";
+    }
+    return "UNKNOWN";
+}
+
+// 不依赖 gmtime（非异步信号安全）的 UTC 时间渲染：YYYY-MM-DD HH:MM:SS.ffffffZ
+void write_utc(int fd, const std::chrono::system_clock::time_point& tp) {
+    const long long us = std::chrono::duration_cast<std::chrono::microseconds>(
+        tp.time_since_epoch()).count();
+    long long secs = us / 1000000;
+    long long frac = us % 1000000;
+    if (frac < 0) {
+        frac += 1000000;
+        --secs;
+    }
+    long long days = secs / 86400;
+    long long rem = secs % 86400;
+    if (rem < 0) {
+        rem += 86400;
+        --days;
+    }
+    // 公历日期换算（Howard Hinnant civil_from_days）
+    days += 719468;
+    const long long era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned day = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    const long long year = static_cast<long long>(yoe) + era * 400 + (month <= 2 ? 1 : 0);
+
+    char buf[32];
+    const unsigned y = static_cast<unsigned>(year);
+    buf[0] = static_cast<char>('0' + y / 1000 % 10);
+    buf[1] = static_cast<char>('0' + y / 100 % 10);
+    buf[2] = static_cast<char>('0' + y / 10 % 10);
+    buf[3] = static_cast<char>('0' + y % 10);
+    buf[4] = '-';
+    format_2(buf + 5, month);
+    buf[7] = '-';
+    format_2(buf + 8, day);
+    buf[10] = ' ';
+    format_2(buf + 11, static_cast<unsigned>(rem / 3600));
+    buf[13] = ':';
+    format_2(buf + 14, static_cast<unsigned>(rem / 60 % 60));
+    buf[16] = ':';
+    format_2(buf + 17, static_cast<unsigned>(rem % 60));
+    buf[19] = '.';
+    unsigned f = static_cast<unsigned>(frac);
+    for (int i = 25; i >= 20; --i) {
+        buf[i] = static_cast<char>('0' + f % 10);
+        f /= 10;
+    }
+    buf[26] = 'Z';
+    XZeroCrash::write_all(fd, buf, 27);
+}
+
+} // namespace
+
+namespace XZeroCrash {
+
+void install() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+#if !defined(_WIN32)
+        stack_t ss;
+        std::memset(&ss, 0, sizeof(ss));
+        ss.ss_sp = g_alt_stack;
+        ss.ss_size = sizeof(g_alt_stack);
+        ::sigaltstack(&ss, nullptr); // 仅对安装线程生效
+        for (std::size_t i = 0; i < kNumSignals; ++i) {
+            struct sigaction sa;
+            std::memset(&sa, 0, sizeof(sa));
+            sa.sa_handler = xzero_fatal_signal;
+            sigemptyset(&sa.sa_mask);
+            sa.sa_flags = SA_ONSTACK;
+            ::sigaction(kFatalSignals[i], &sa, &g_previous[i]);
+        }
+#else
+        for (std::size_t i = 0; i < kNumSignals; ++i) {
+            g_previous[i] = std::signal(kFatalSignals[i], xzero_fatal_signal);
+            if (g_previous[i] == SIG_ERR) g_previous[i] = nullptr;
+        }
+#endif
+        std::atexit(drain_at_exit);
+        std::at_quick_exit(drain_at_exit);
+    });
+}
+
+void register_backend(LogBackend* backend) {
+    for (std::size_t i = 0; i < kMaxBackends; ++i) {
+        LogBackend* expected = nullptr;
+        if (g_backends[i].compare_exchange_strong(expected, backend)) return;
+    }
+}
+
+void unregister_backend(LogBackend* backend) {
+    for (std::size_t i = 0; i < kMaxBackends; ++i) {
+        LogBackend* expected = backend;
+        if (g_backends[i].compare_exchange_strong(expected, nullptr)) return;
+    }
+}
+
+void write_all(int fd, const char* data, std::size_t n) {
+    while (n > 0) {
+#if defined(_WIN32)
+        const int w = _write(fd, data, static_cast<unsigned>(n));
+#else
+        const ssize_t w = ::write(fd, data, n);
+        if (w < 0 && errno == EINTR) continue;
+#endif
+        if (w <= 0) return;
+        data += w;
+        n -= static_cast<std::size_t>(w);
+    }
+}
+
+void write_str(int fd, const char* s) {
+    if (s) write_all(fd, s, std::strlen(s));
+}
+
+void write_uint(int fd, unsigned long long value) {
+    char buf[24];
+    std::size_t pos = sizeof(buf);
+    do {
+        buf[--pos] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    write_all(fd, buf + pos, sizeof(buf) - pos);
+}
+
+void write_record(int fd, const LogRecord& rec) {
+    write_str(fd, "[");
+    write_utc(fd, rec.timestamp);
+    write_str(fd, "] [");
+    write_str(fd, level_name(rec.level));
+    write_str(fd, "] [");
+    if (rec.thread) {
+        write_all(fd, rec.thread->human.data(), rec.thread->human.size());
+    } else {
+        write_str(fd, "TID:");
+        write_uint(fd, rec.threadId);
+    }
+    write_str(fd, "] ");
+    if (!rec.logger.empty()) {
+        write_str(fd, "[");
+        write_all(fd, rec.logger.data(), rec.logger.size());
+        write_str(fd, "] ");
+    }
+    if (rec.file) {
+        write_str(fd, "(");
+        write_str(fd, rec.file);
+        write_str(fd, ":");
+        write_uint(fd, static_cast<unsigned long long>(rec.line));
+        write_str(fd, " ");
+        write_str(fd, rec.func);
+        write_str(fd, ") - ");
+    }
+    write_all(fd, rec.message.data(), rec.message.size());
+    write_str(fd, " (Error Code: ");
+    if (rec.errorCode < 0) {
+        write_str(fd, "-");
+        write_uint(fd, static_cast<unsigned long long>(-static_cast<long long>(rec.errorCode)));
+    } else {
+        write_uint(fd, static_cast<unsigned long long>(rec.errorCode));
+    }
+    write_str(fd, ")\n");
+}
+
+} // namespace XZeroCrash
@@ -0,0 +1,177 @@
+#include "LogField.h"
+
+#include "JsonEscape.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+void put_varint(std::string& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+void append_uint(std::string& out, unsigned long long v) {
+    char buf[24];
+    char* end = buf + sizeof(buf);
+    char* p = end;
+    do {
+        *--p = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    out.append(p, static_cast<std::size_t>(end - p));
+}
+
+void append_int(std::string& out, long long v) {
+    if (v < 0) {
+        out.push_back('-');
+        append_uint(out, 0ULL - static_cast<unsigned long long>(v));
+    } else {
+        append_uint(out, static_cast<unsigned long long>(v));
+    }
+}
+
+// 最短且可无损读回的十进制表示：先试 15 位有效数字，读回不等再用 17 位
+void append_double(std::string& out, double v) {
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), "%.15g", v);
+    if (std::strtod(buf, nullptr) != v) {
+        n = std::snprintf(buf, sizeof(buf), "%.17g", v);
+    }
+    out.append(buf, static_cast<std::size_t>(n));
+}
+
+// Human-Friendly 的字符串值：含空白、'='、'"' 或控制字符（以及空串）时加引号并转义，
+// 否则原样输出；避免值中的空格 / '=' 使 k=v 产生歧义，或以换行伪造出新的日志行
+bool needs_quote(const char* p, std::size_t n) {
+    if (n == 0) return true;
+    for (std::size_t i = 0; i < n; ++i) {
+        const unsigned char c = static_cast<unsigned char>(p[i]);
+        if (c <= 0x20 || c == 0x7F || c == '=' || c == '"') return true;
+    }
+    return false;
+}
+
+void append_quoted(std::string& out, const char* p, std::size_t n) {
+    static const char kHex[] = "0123456789abcdef";
+    out.push_back('"');
+    for (std::size_t i = 0; i < n; ++i) {
+        const unsigned char c = static_cast<unsigned char>(p[i]);
+        switch (c) {
+        case '"':  out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default:
+            if (c < 0x20 || c == 0x7F) {
+                out.append("\\x");
+                out.push_back(kHex[c >> 4]);
+                out.push_back(kHex[c & 0xF]);
+            } else {
+                out.push_back(static_cast<char>(c));
+            }
+            break;
+        }
+    }
+    out.push_back('"');
+}
+
+void append_value(std::string& out, const LogField& f, bool json) {
+    switch (f.type()) {
+    case LogField::Type::Int:
+        append_int(out, f.as_int());
+        break;
+    case LogField::Type::UInt:
+        append_uint(out, f.as_uint());
+        break;
+    case LogField::Type::Double:
+        if (std::isfinite(f.as_double())) {
+            append_double(out, f.as_double());
+        } else if (json) {
+            out.append("null"); // JSON 无 NaN / Infinity
+        } else {
+            out.append(std::isnan(f.as_double()) ? "nan" : (f.as_double() > 0 ? "inf" : "-inf"));
+        }
+        break;
+    case LogField::Type::Bool:
+        out.append(f.as_bool() ? "true" : "false");
+        break;
+    case LogField::Type::String:
+        if (json) {
+            out.push_back('"');
+            XZeroJson::escape_append(out, f.str_data(), f.str_size());
+            out.push_back('"');
+        } else if (needs_quote(f.str_data(), f.str_size())) {
+            append_quoted(out, f.str_data(), f.str_size());
+        } else {
+            out.append(f.str_data(), f.str_size());
+        }
+        break;
+    }
+}
+
+} // namespace
+
+void XZeroFields::encode(const LogField* fields, std::size_t n, std::string& out) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const LogField& f = fields[i];
+        out.push_back(static_cast<char>(f.type()));
+        put_varint(out, f.key_size());
+        out.append(f.key(), f.key_size());
+        switch (f.type()) {
+        case LogField::Type::Int: {
+            const long long v = f.as_int();
+            put_varint(out, (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+            break;
+        }
+        case LogField::Type::UInt:
+            put_varint(out, f.as_uint());
+            break;
+        case LogField::Type::Double: {
+            const double d = f.as_double();
+            std::uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            for (int b = 0; b < 8; ++b) {
+                out.push_back(static_cast<char>((bits >> (8 * b)) & 0xFF));
+            }
+            break;
+        }
+        case LogField::Type::Bool:
+            out.push_back(f.as_bool() ? 1 : 0);
+            break;
+        case LogField::Type::String:
+            put_varint(out, f.str_size());
+            out.append(f.str_data(), f.str_size());
+            break;
+        }
+    }
+}
+
+void XZeroFields::append_human(std::string& out, const std::string& encoded) {
+    for_each(encoded, [&out](const LogField& f) {
+        out.push_back(' ');
+        out.append(f.key(), f.key_size());
+        out.push_back('=');
+        append_value(out, f, false);
+    });
+}
+
+void XZeroFields::append_json(std::string& out, const std::string& encoded) {
+    out.append(",\"fields\":{");
+    bool first = true;
+    for_each(encoded, [&out, &first](const LogField& f) {
+        if (!first) out.push_back(',');
+        out.push_back('"');
+        XZeroJson::escape_append(out, f.key(), f.key_size());
+        out.append("\":");
+        append_value(out, f, true);
+        first = false;
+    });
+    out.push_back('}');
+}
@@ -0,0 +1,319 @@
+#include "LogFile.h"
+
+#include "LogCrash.h"
+
+#include <cerrno>
+#include <fcntl.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <climits>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if !defined(_WIN32)
+#if defined(IOV_MAX)
+const std::size_t kMaxIov = IOV_MAX;
+#else
+const std::size_t kMaxIov = 1024;
+#endif
+
+std::size_t page_size() {
+    static const std::size_t size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+std::size_t round_up_page(std::size_t n) {
+    const std::size_t page = page_size();
+    return (n + page - 1) / page * page;
+}
+
+// 崩溃恢复：从尾部向前跳过预分配遗留的 0 字节，返回有效数据长度
+std::size_t recover_length(int fd, std::size_t file_size) {
+    char buf[64 * 1024];
+    std::size_t end = file_size;
+    while (end > 0) {
+        const std::size_t chunk = end < sizeof(buf) ? end : sizeof(buf);
+        const std::size_t start = end - chunk;
+        const ssize_t n = ::pread(fd, buf, chunk, static_cast<off_t>(start));
+        if (n != static_cast<ssize_t>(chunk)) return file_size; // 读失败时保守处理
+        for (std::size_t i = chunk; i > 0; --i) {
+            if (buf[i - 1] != '\0') return start + i;
+        }
+        end = start;
+    }
+    return 0;
+}
+#endif
+
+} // namespace
+
+LogFile::~LogFile() {
+    close();
+}
+
+bool LogFile::open(const std::string& path, bool truncate) {
+    close();
+#if defined(_WIN32)
+    const int flags = _O_WRONLY | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : _O_APPEND);
+    fd_ = _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+    const int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : O_APPEND);
+    fd_ = ::open(path.c_str(), flags, 0644);
+#endif
+    if (fd_ < 0) return false;
+#if defined(_WIN32)
+    base_size_ = static_cast<std::size_t>(_lseeki64(fd_, 0, SEEK_END));
+#else
+    struct stat st;
+    base_size_ = ::fstat(fd_, &st) == 0 ? static_cast<std::size_t>(st.st_size) : 0;
+#endif
+    return true;
+}
+
+bool LogFile::open_mapped(const std::string& path, bool truncate, std::size_t segment_bytes) {
+#if defined(_WIN32)
+    (void)segment_bytes;
+    return open(path, truncate);
+#else
+    close();
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+    if (fd_ < 0) return false;
+
+    std::size_t length = 0;
+    struct stat st;
+    if (!truncate && ::fstat(fd_, &st) == 0 && st.st_size > 0) {
+        length = recover_length(fd_, static_cast<std::size_t>(st.st_size));
+        if (length != static_cast<std::size_t>(st.st_size)) {
+            // 上次未正常关闭：截掉尾部 0 填充
+            if (::ftruncate(fd_, static_cast<off_t>(length)) != 0) {
+                close();
+                return false;
+            }
+        }
+    }
+    base_size_ = length;
+    mapped_ = true;
+    segment_bytes_ = round_up_page(segment_bytes > 0 ? segment_bytes : 1);
+    if (!map_reserve(length + 1)) {
+        close();
+        return false;
+    }
+    return true;
+#endif
+}
+
+void LogFile::close() {
+    if (fd_ < 0) return;
+    flush();
+    map_release();
+#if defined(_WIN32)
+    _close(fd_);
+#else
+    ::close(fd_);
+#endif
+    fd_ = -1;
+    base_size_ = 0;
+    mapped_ = false;
+    map_failed_ = false;
+}
+
+bool LogFile::map_reserve(std::size_t required) {
+#if defined(_WIN32)
+    (void)required;
+    return false;
+#else
+    if (map_ && required <= map_capacity_) return true;
+    std::size_t capacity = map_capacity_ + segment_bytes_;
+    if (capacity < required) capacity = required;
+    capacity = round_up_page(capacity);
+
+    if (map_) {
+        ::munmap(map_, map_capacity_);
+        map_ = nullptr;
+    }
+    // 预分配真实磁盘块，避免稀疏文件在磁盘写满时触发 SIGBUS；文件系统不支持时退回 ftruncate
+    int rc = ::posix_fallocate(fd_, 0, static_cast<off_t>(capacity));
+    if (rc != 0 && ::ftruncate(fd_, static_cast<off_t>(capacity)) != 0) {
+        map_capacity_ = 0;
+        return false;
+    }
+    void* p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) {
+        map_capacity_ = 0;
+        return false;
+    }
+    map_ = static_cast<char*>(p);
+    map_capacity_ = capacity;
+    return true;
+#endif
+}
+
+bool LogFile::map_append(const char* data, std::size_t n) {
+#if defined(_WIN32)
+    (void)data; (void)n;
+    return false;
+#else
+    if (!map_reserve(base_size_ + n)) {
+        map_failed_ = true;
+        return false;
+    }
+    std::memcpy(map_ + base_size_, data, n);
+    base_size_ += n;
+    return true;
+#endif
+}
+
+void LogFile::map_release() {
+#if !defined(_WIN32)
+    if (!mapped_) return;
+    if (map_) {
+        ::munmap(map_, map_capacity_);
+        map_ = nullptr;
+    }
+    map_capacity_ = 0;
+    // 去掉预分配但未使用的尾部
+    if (::ftruncate(fd_, static_cast<off_t>(base_size_)) != 0) {
+        // 截断失败时尾部保留 0 填充，下次打开由 recover_length 处理
+    }
+#endif
+}
+
+void LogFile::add_ref(const char* data, std::size_t n) {
+    if (n == 0) return;
+    if (mapped_) {
+        map_append(data, n);
+        return;
+    }
+    refs_.push_back(Slice{data, n});
+    pending_bytes_ += n;
+}
+
+void LogFile::add_copy(const char* data, std::size_t n) {
+    if (n == 0) return;
+    if (mapped_) {
+        map_append(data, n);
+        return;
+    }
+    materialize();
+    buffer_.append(data, n);
+    pending_bytes_ += n;
+}
+
+void LogFile::materialize() {
+    for (const auto& s : refs_) {
+        buffer_.append(s.data, s.len);
+    }
+    refs_.clear();
+}
+
+bool LogFile::end_batch(bool flush_now) {
+    if (flush_now) return flush();
+    materialize();
+    return true;
+}
+
+bool LogFile::flush() {
+    if (mapped_) {
+        // 数据已在映射中，无需系统调用；仅汇报期间的写入失败
+        const bool ok = !map_failed_;
+        map_failed_ = false;
+        return ok;
+    }
+    if (pending_bytes_ == 0) return true;
+    if (fd_ < 0) {
+        buffer_.clear();
+        refs_.clear();
+        pending_bytes_ = 0;
+        return false;
+    }
+    std::vector<Slice> slices;
+    slices.reserve(refs_.size() + 1);
+    if (!buffer_.empty()) slices.push_back(Slice{buffer_.data(), buffer_.size()});
+    slices.insert(slices.end(), refs_.begin(), refs_.end());
+    const bool ok = write_all(slices);
+    base_size_ += pending_bytes_;
+    buffer_.clear();
+    refs_.clear();
+    pending_bytes_ = 0;
+    return ok;
+}
+
+bool LogFile::sync() {
+    if (fd_ < 0) return false;
+#if defined(_WIN32)
+    return _commit(fd_) == 0;
+#else
+    if (mapped_) {
+        return !map_ || base_size_ == 0 || ::msync(map_, base_size_, MS_SYNC) == 0;
+    }
+    int rc;
+    do {
+#if defined(__APPLE__)
+        rc = ::fsync(fd_); // macOS 没有 fdatasync
+#else
+        rc = ::fdatasync(fd_);
+#endif
+    } while (rc != 0 && errno == EINTR);
+    // 管道、字符设备等不支持同步的目标视为成功
+    return rc == 0 || errno == EINVAL;
+#endif
+}
+
+void LogFile::emergency_flush() const {
+    // mmap 模式的数据已在页缓存中，进程崩溃不会丢失
+    if (fd_ < 0 || mapped_ || pending_bytes_ == 0) return;
+    // 内部拷贝总在外部引用之前
+    XZeroCrash::write_all(fd_, buffer_.data(), buffer_.size());
+    for (const Slice& s : refs_) {
+        XZeroCrash::write_all(fd_, s.data, s.len);
+    }
+}
+
+bool LogFile::write_all(std::vector<Slice>& slices) {
+#if defined(_WIN32)
+    for (auto& s : slices) {
+        while (s.len > 0) {
+            const int n = _write(fd_, s.data, static_cast<unsigned>(s.len));
+            if (n < 0) return false;
+            s.data += n;
+            s.len -= static_cast<std::size_t>(n);
+        }
+    }
+    return true;
+#else
+    std::vector<struct iovec> iov(slices.size());
+    for (std::size_t i = 0; i < slices.size(); ++i) {
+        iov[i].iov_base = const_cast<char*>(slices[i].data);
+        iov[i].iov_len = slices[i].len;
+    }
+    std::size_t first = 0;
+    while (first < iov.size()) {
+        const std::size_t count = iov.size() - first < kMaxIov ? iov.size() - first : kMaxIov;
+        const ssize_t n = ::writev(fd_, &iov[first], static_cast<int>(count));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        // 处理部分写入：跳过已完整写出的 iovec，并截短下一个
+        std::size_t written = static_cast<std::size_t>(n);
+        while (first < iov.size() && written >= iov[first].iov_len) {
+            written -= iov[first].iov_len;
+            ++first;
+        }
+        if (first < iov.size() && written > 0) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + written;
+            iov[first].iov_len -= written;
+        }
+    }
+    return true;
+#endif
+}
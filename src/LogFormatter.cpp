@@ -0,0 +1,188 @@
+#include "LogFormatter.h"
+
+#include "JsonEscape.h"
+#include "LogField.h"
+#include "LogSite.h"
+#include "LogThread.h"
+#include "LogTime.h"
+#include "Logger.h"
+
+
+namespace {
+
+// 整数直接写入输出缓冲，避免 ostringstream / to_string 临时对象
+void append_uint(std::string& out, unsigned long long v) {
+    char buf[24];
+    char* end = buf + sizeof(buf);
+    char* p = end;
+    do {
+        *--p = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    out.append(p, static_cast<std::size_t>(end - p));
+}
+
+void append_int(std::string& out, long long v) {
+    if (v < 0) {
+        out.push_back('-');
+        append_uint(out, 0ULL - static_cast<unsigned long long>(v));
+    } else {
+        append_uint(out, static_cast<unsigned long long>(v));
+    }
+}
+
+void append_json_string(std::string& out, const std::string& s) {
+    out.push_back('\"');
+    XZeroJson::escape_append(out, s);
+    out.push_back('\"');
+}
+
+} // namespace
+
+LogFormatter::LogFormatter(const LoggerConfig& cfg, const std::string& platform)
+    : config_(cfg), platform_(platform),
+      flags_((cfg.writeTime ? kFormatTime : 0u) | (cfg.includePlatform ? kFormatPlatform : 0u) |
+             (cfg.includeSource ? kFormatSource : 0u) | (cfg.includeMdc ? kFormatMdc : 0u) |
+             (cfg.useErrorCode ? kFormatErrorCode : 0u)) {}
+
+void LogFormatter::set_flag(FormatFlag flag, bool enabled) {
+    if (enabled) {
+        flags_.fetch_or(flag, std::memory_order_relaxed);
+    } else {
+        flags_.fetch_and(~static_cast<unsigned>(flag), std::memory_order_relaxed);
+    }
+}
+
+std::string LogFormatter::format(const LogRecord& rec) const {
+    return format(rec, config_.logFormat);
+}
+
+std::string LogFormatter::format(const LogRecord& rec, LogFormat format) const {
+    // 整条记录使用同一份开关快照
+    const unsigned flags = flags_.load(std::memory_order_relaxed);
+    return format == LogFormat::Json ? format_json(rec, flags) : format_human(rec, flags);
+}
+
+void LogFormatter::append_source(std::string& out, const LogRecord& rec, bool json) const {
+    // 经宏记录的调用点已预渲染（JSON 版本已转义），直接拷贝
+    if (rec.site) {
+        out.append(json ? rec.site->source_json : rec.site->source);
+        return;
+    }
+    const char* base = XZeroSite::basename(rec.file);
+    std::string s(base);
+    if (rec.line > 0) {
+        s.push_back(':');
+        append_int(s, rec.line);
+    }
+    if (rec.func && *rec.func) {
+        s.push_back(' ');
+        s.append(rec.func);
+    }
+    if (json) {
+        XZeroJson::escape_append(out, s);
+    } else {
+        out.append(s);
+    }
+}
+
+std::string LogFormatter::format_json(const LogRecord& rec, unsigned flags) const {
+    std::string out;
+    out.reserve(160 + rec.message.size());
+    out.append("{\"timestamp\":\"");
+    if (flags & kFormatTime) {
+        char ts[XZeroTime::kMaxTimestampLen];
+        out.append(ts, XZeroTime::format_utc(rec.timestamp, config_.timePrecision, ts));
+    }
+    out.append("\",\"OS\":\"");
+    if (flags & kFormatPlatform) {
+        XZeroJson::escape_append(out, platform_);
+    }
+    out.append("\",\"level\":\"");
+    out.append(Logger::level_to_string(rec.level));
+    out.append("\",");
+    if (rec.thread) {
+        // 预渲染的线程片段直接拷贝
+        out.append(rec.thread->json);
+    } else {
+        out.append("\"thread\":\"TID:");
+        append_uint(out, rec.threadId);
+        out.push_back('\"');
+    }
+    if (!rec.logger.empty()) {
+        out.append(",\"name\":");
+        append_json_string(out, rec.logger);
+    }
+    if ((flags & kFormatSource) && rec.file) {
+        out.append(",\"logger\":\"");
+        append_source(out, rec, true);
+        out.push_back('\"');
+    }
+    out.append(",\"message\":");
+    append_json_string(out, rec.message);
+    if (!rec.fields.empty()) {
+        XZeroFields::append_json(out, rec.fields);
+    }
+    if ((flags & kFormatMdc) && rec.mdc) {
+        // 快照携带预渲染并转义好的片段
+        out.append(rec.mdc->json);
+    }
+    if (flags & kFormatErrorCode) {
+        out.append(",\"error_code\":");
+        append_int(out, rec.errorCode);
+    }
+    out.push_back('}');
+    return out;
+}
+
+std::string LogFormatter::format_human(const LogRecord& rec, unsigned flags) const {
+    std::string out;
+    out.reserve(128 + rec.message.size());
+    if (flags & kFormatTime) {
+        char ts[XZeroTime::kMaxTimestampLen];
+        out.push_back('[');
+        out.append(ts, XZeroTime::format_local(rec.timestamp, config_.timePrecision, ts));
+        out.append("] ");
+    }
+    if (flags & kFormatPlatform) {
+        out.push_back('[');
+        out.append(platform_);
+        out.append("] ");
+    }
+    // 等级左对齐补足 6 列
+    const std::string level_str = Logger::level_to_string(rec.level);
+    out.push_back('[');
+    out.append(level_str);
+    if (level_str.size() < 6) out.append(6 - level_str.size(), ' ');
+    out.append("] [");
+    if (rec.thread) {
+        out.append(rec.thread->human);
+    } else {
+        out.append("TID:");
+        append_uint(out, rec.threadId);
+    }
+    out.append("] ");
+    if (!rec.logger.empty()) {
+        out.push_back('[');
+        out.append(rec.logger);
+        out.append("] ");
+    }
+    if ((flags & kFormatSource) && rec.file) {
+        out.push_back('(');
+        append_source(out, rec, false);
+        out.append(") - ");
+    }
+    out.append(rec.message);
+    if (!rec.fields.empty()) {
+        XZeroFields::append_human(out, rec.fields);
+    }
+    if ((flags & kFormatMdc) && rec.mdc) {
+        out.append(rec.mdc->human);
+    }
+    if (flags & kFormatErrorCode) {
+        out.append(" (Error Code: ");
+        append_int(out, rec.errorCode);
+        out.push_back(')');
+    }
+    return out;
+}
@@ -0,0 +1,242 @@
+#include "LogMaintenance.h"
+
+#include "LogCompress.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sys/stat.h>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <dirent.h>
+#include <utime.h>
+#endif
+
+namespace {
+
+// 可能出现的备份后缀：未压缩、内置 LZ4、gzip（切换压缩配置后旧备份仍能被轮转与清理）
+const char* const kBackupExts[] = {"", ".xzlz", ".gz"};
+
+bool stat_file(const std::string& path, struct stat& st) {
+    return ::stat(path.c_str(), &st) == 0 && (st.st_mode & S_IFREG) != 0;
+}
+
+// 压缩产物沿用原文件的修改时间，使按时间清理以日志内容为准
+void copy_mtime(const struct stat& from, const std::string& to) {
+#if !defined(_WIN32)
+    struct utimbuf times;
+    times.actime = from.st_atime;
+    times.modtime = from.st_mtime;
+    ::utime(to.c_str(), &times);
+#else
+    (void)from;
+    (void)to;
+#endif
+}
+
+// 列出 dir 中以 prefix 开头的文件名（不含目录）
+std::vector<std::string> list_prefixed(const std::string& dir, const std::string& prefix) {
+    std::vector<std::string> names;
+#if defined(_WIN32)
+    struct _finddata_t data;
+    const intptr_t handle = _findfirst((dir + "/" + prefix + "*").c_str(), &data);
+    if (handle == -1) return names;
+    do {
+        names.push_back(data.name);
+    } while (_findnext(handle, &data) == 0);
+    _findclose(handle);
+#else
+    DIR* d = ::opendir(dir.c_str());
+    if (!d) return names;
+    while (struct dirent* e = ::readdir(d)) {
+        const std::string name = e->d_name;
+        if (name.compare(0, prefix.size(), prefix) == 0) names.push_back(name);
+    }
+    ::closedir(d);
+#endif
+    return names;
+}
+
+// 解析暂存名后缀 "<ns>.<seq>"；格式不符返回 false
+bool parse_staging_suffix(const std::string& suffix, unsigned long long& ns, unsigned long long& seq) {
+    const std::size_t dot = suffix.find('.');
+    if (dot == 0 || dot == std::string::npos || dot + 1 == suffix.size()) return false;
+    if (suffix.find_first_not_of("0123456789.") != std::string::npos ||
+        suffix.find('.', dot + 1) != std::string::npos) {
+        return false;
+    }
+    ns = std::strtoull(suffix.c_str(), nullptr, 10);
+    seq = std::strtoull(suffix.c_str() + dot + 1, nullptr, 10);
+    return true;
+}
+
+long long now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+LogMaintenance::LogMaintenance(const LoggerConfig& cfg)
+    : config_(cfg), started_ns_(static_cast<unsigned long long>(now_ns())) {
+    // 启动时先执行一次清理：上次运行遗留的暂存文件与过期/超额备份
+    jobs_.push_back(std::string());
+    worker_ = std::thread(&LogMaintenance::run, this);
+}
+
+LogMaintenance::~LogMaintenance() {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+std::string LogMaintenance::staging_path() {
+    // 时间戳 + 序号，避免与上次运行崩溃时遗留的暂存文件重名
+    return config_.filePath + ".rotating." + std::to_string(now_ns()) + "." + std::to_string(seq_++);
+}
+
+void LogMaintenance::submit(const std::string& staged) {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        jobs_.push_back(staged);
+    }
+    cv_.notify_one();
+}
+
+void LogMaintenance::wait_idle() {
+    std::unique_lock<std::mutex> lk(mutex_);
+    idle_cv_.wait(lk, [this] { return jobs_.empty() && !busy_; });
+}
+
+void LogMaintenance::run() {
+    std::unique_lock<std::mutex> lk(mutex_);
+    while (true) {
+        cv_.wait(lk, [this] { return stop_ || !jobs_.empty(); });
+        if (jobs_.empty()) break; // stop_ 且任务已处理完
+        const std::string staged = jobs_.front();
+        jobs_.pop_front();
+        busy_ = true;
+        lk.unlock();
+        process(staged);
+        lk.lock();
+        busy_ = false;
+        if (jobs_.empty()) idle_cv_.notify_all();
+    }
+}
+
+void LogMaintenance::process(const std::string& staged) {
+    struct stat staged_st;
+    if (staged.empty()) {
+        recover_staged();
+    } else if (stat_file(staged, staged_st)) {
+        if (config_.maxBackupFiles == 0) {
+            // 不保留备份
+            std::remove(staged.c_str());
+        } else {
+            shift_backups();
+            const BackupCompression kind = XZeroCompress::effective(config_.backupCompression);
+            bool placed = false;
+            if (kind != BackupCompression::None) {
+                struct stat st;
+                const bool have_stat = stat_file(staged, st);
+                // 先写临时名再改名，清理逻辑永远看不到半成品
+                const std::string target = backup_path(1, XZeroCompress::extension(kind));
+                const std::string tmp = target + ".tmp";
+                if (XZeroCompress::compress_file(staged, tmp, kind) &&
+                    std::rename(tmp.c_str(), target.c_str()) == 0) {
+                    if (have_stat) copy_mtime(st, target);
+                    std::remove(staged.c_str());
+                    placed = true;
+                } else {
+                    std::remove(tmp.c_str());
+                }
+            }
+            if (!placed) {
+                // 不压缩或压缩失败：原样作为最新备份
+                std::rename(staged.c_str(), backup_path(1, "").c_str());
+            }
+        }
+    }
+    enforce_retention();
+}
+
+void LogMaintenance::recover_staged() {
+    // 上次运行在 rename 之后、任务完成之前退出时遗留的暂存文件：按生成顺序从旧到新补做轮转，
+    // 使其与普通备份一样受 maxBackupFiles / maxBackupTotalBytes / maxBackupAgeSeconds 约束。
+    // 只处理本实例创建之前生成的暂存名，本次运行滚动出的暂存文件由各自提交的任务处理
+    const std::size_t slash = config_.filePath.find_last_of("/\\");
+    const std::string dir = slash == std::string::npos ? "." : config_.filePath.substr(0, slash);
+    const std::string prefix =
+        (slash == std::string::npos ? config_.filePath : config_.filePath.substr(slash + 1)) +
+        ".rotating.";
+
+    std::vector<std::pair<std::pair<unsigned long long, unsigned long long>, std::string>> leftovers;
+    for (const std::string& name : list_prefixed(dir, prefix)) {
+        unsigned long long ns = 0;
+        unsigned long long seq = 0;
+        if (!parse_staging_suffix(name.substr(prefix.size()), ns, seq) || ns >= started_ns_) {
+            continue;
+        }
+        leftovers.push_back(std::make_pair(std::make_pair(ns, seq), dir + "/" + name));
+    }
+    std::sort(leftovers.begin(), leftovers.end());
+    for (const auto& leftover : leftovers) {
+        process(leftover.second);
+    }
+}
+
+void LogMaintenance::shift_backups() {
+    // log.N 删除，log.(i) -> log.(i+1)
+    const std::size_t max = config_.maxBackupFiles;
+    for (const char* ext : kBackupExts) {
+        std::remove(backup_path(max, ext).c_str());
+    }
+    for (std::size_t i = max; i > 1; --i) {
+        for (const char* ext : kBackupExts) {
+            const std::string source = backup_path(i - 1, ext);
+            struct stat st;
+            if (stat_file(source, st)) {
+                std::rename(source.c_str(), backup_path(i, ext).c_str());
+            }
+        }
+    }
+}
+
+void LogMaintenance::enforce_retention() {
+    if (config_.maxBackupTotalBytes == 0 && config_.maxBackupAgeSeconds == 0) return;
+
+    // 从最新（.1）到最旧累计；超出总量或过期的备份删除
+    const std::time_t now = std::time(nullptr);
+    unsigned long long total = 0;
+    for (std::size_t i = 1; i <= config_.maxBackupFiles; ++i) {
+        for (const char* ext : kBackupExts) {
+            const std::string path = backup_path(i, ext);
+            struct stat st;
+            if (!stat_file(path, st)) continue;
+            total += static_cast<unsigned long long>(st.st_size);
+            const bool over_size =
+                config_.maxBackupTotalBytes > 0 && total > config_.maxBackupTotalBytes;
+            const bool expired = config_.maxBackupAgeSeconds > 0 && now > st.st_mtime &&
+                                 static_cast<unsigned long long>(now - st.st_mtime) >
+                                     config_.maxBackupAgeSeconds;
+            if (over_size || expired) {
+                std::remove(path.c_str());
+            }
+        }
+    }
+}
+
+std::string LogMaintenance::backup_path(std::size_t index, const char* ext) const {
+    return config_.filePath + "." + std::to_string(index) + ext;
+}
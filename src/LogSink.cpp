@@ -0,0 +1,93 @@
+#include "LogSink.h"
+
+#include "Logger.h"
+
+#include <iterator>
+#include <utility>
+#include <vector>
+
+void LogSink::set_level(LoggerLevel level) {
+    min_severity_.store(Logger::severity(level), std::memory_order_relaxed);
+}
+
+bool LogSink::accepts(LoggerLevel level) const {
+    return Logger::severity(level) >= min_severity_.load(std::memory_order_relaxed);
+}
+
+AsyncSink::AsyncSink(std::shared_ptr<LogSink> inner, std::size_t capacity, std::size_t idle_ms)
+    : LogSink(inner->format()), inner_(std::move(inner)), queue_(capacity),
+      idle_wait_(idle_ms > 0 ? idle_ms : 1) {
+    worker_ = std::thread(&AsyncSink::worker_loop, this);
+}
+
+AsyncSink::~AsyncSink() {
+    {
+        std::lock_guard<std::mutex> lk(wake_mutex_);
+        stop_.store(true, std::memory_order_release);
+    }
+    cv_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void AsyncSink::write(const LogEntry& entry) {
+    post(std::make_shared<const LogEntry>(entry));
+}
+
+void AsyncSink::post(const std::shared_ptr<const LogEntry>& entry) {
+    // 队列满时让出 CPU 并催促后台线程（不丢日志），协议同 FileLogger::enqueue
+    while (!queue_.try_push(entry)) {
+        wake_worker();
+        std::this_thread::yield();
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        wake_worker();
+    }
+}
+
+void AsyncSink::wake_worker() {
+    std::lock_guard<std::mutex> lk(wake_mutex_);
+    cv_.notify_one();
+}
+
+void AsyncSink::worker_loop() {
+    const std::size_t kBatch = 64;
+    std::vector<std::shared_ptr<const LogEntry>> batch;
+    batch.reserve(kBatch);
+
+    auto write_batch = [&] {
+        for (const auto& entry : batch) {
+            if (inner_->accepts(entry->record.level)) {
+                inner_->write(*entry);
+            }
+        }
+        inner_->flush();
+        batch.clear();
+    };
+
+    while (true) {
+        queue_.pop_bulk(std::back_inserter(batch), kBatch);
+        if (!batch.empty()) {
+            write_batch();
+            continue;
+        }
+        if (stop_.load(std::memory_order_acquire)) {
+            while (queue_.pop_bulk(std::back_inserter(batch), kBatch) > 0) {
+                write_batch();
+            }
+            break;
+        }
+
+        inner_->on_idle();
+
+        std::unique_lock<std::mutex> lk(wake_mutex_);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_.empty() && !stop_.load(std::memory_order_acquire)) {
+            cv_.wait_for(lk, idle_wait_);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
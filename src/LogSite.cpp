@@ -0,0 +1,23 @@
+#include "LogSite.h"
+
+#include "JsonEscape.h"
+
+const LogSite& XZeroSite::make(const char* file, const char* base, int line, const char* func) {
+    LogSite* site = new LogSite;
+    site->file = file;
+    site->base = base ? base : "";
+    site->line = line;
+    site->func = func;
+    // 与 LogFormatter 的源信息格式一致："file.cpp:120 func"
+    site->source = site->base;
+    if (line > 0) {
+        site->source.push_back(':');
+        site->source.append(std::to_string(line));
+    }
+    if (func && *func) {
+        site->source.push_back(' ');
+        site->source.append(func);
+    }
+    XZeroJson::escape_append(site->source_json, site->source);
+    return *site;
+}
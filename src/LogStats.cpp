@@ -0,0 +1,144 @@
+#include "LogStats.h"
+
+#include <cstdio>
+
+namespace {
+
+unsigned highest_bit(std::uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(v));
+#else
+    unsigned bit = 0;
+    while (v >>= 1) ++bit;
+    return bit;
+#endif
+}
+
+void append_uint(std::string& out, const char* key, std::uint64_t value) {
+    out += '"';
+    out += key;
+    out += "\":";
+    out += std::to_string(value);
+}
+
+} // namespace
+
+LogHistogram::LogHistogram() {
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+std::size_t LogHistogram::bucket_index(std::uint64_t value) {
+    if (value < 2 * kSubBuckets) return static_cast<std::size_t>(value);
+    // 最高位决定区间，其后 3 位决定子桶
+    const unsigned shift = highest_bit(value) - 3;
+    return (shift + 1) * kSubBuckets + static_cast<std::size_t>((value >> shift) & (kSubBuckets - 1));
+}
+
+std::uint64_t LogHistogram::bucket_upper(std::size_t index) {
+    if (index < 2 * kSubBuckets) return index;
+    const unsigned shift = static_cast<unsigned>(index / kSubBuckets - 1);
+    const std::uint64_t sub = index % kSubBuckets;
+    return ((kSubBuckets + sub + 1) << shift) - 1;
+}
+
+void LogHistogram::record(std::uint64_t value) {
+    buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    std::uint64_t cur = max_.load(std::memory_order_relaxed);
+    while (value > cur && !max_.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+    }
+}
+
+LogHistogram::Snapshot LogHistogram::snapshot() const {
+    Snapshot s;
+    s.count = count_.load(std::memory_order_relaxed);
+    if (s.count == 0) return s;
+    s.sum = sum_.load(std::memory_order_relaxed);
+    s.max = max_.load(std::memory_order_relaxed);
+    s.buckets.resize(kBuckets);
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        s.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+std::uint64_t LogHistogram::Snapshot::percentile(double q) const {
+    if (buckets.empty()) return 0;
+    std::uint64_t total = 0;
+    for (std::uint64_t c : buckets) total += c;
+    if (total == 0) return 0;
+    const double target = q * static_cast<double>(total);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen > 0 && static_cast<double>(seen) >= target) {
+            const std::uint64_t upper = bucket_upper(i);
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+void LogHistogram::Snapshot::merge(const Snapshot& other) {
+    if (other.buckets.empty()) return;
+    if (buckets.empty()) buckets.assign(kBuckets, 0);
+    for (std::size_t i = 0; i < kBuckets; ++i) buckets[i] += other.buckets[i];
+    count += other.count;
+    sum += other.sum;
+    if (other.max > max) max = other.max;
+}
+
+std::string LogHistogram::Snapshot::to_json() const {
+    char mean_buf[32];
+    std::snprintf(mean_buf, sizeof(mean_buf), "%.1f", mean());
+    std::string out = "{";
+    append_uint(out, "count", count);
+    out += ",\"mean\":";
+    out += mean_buf;
+    out += ',';
+    append_uint(out, "p50", percentile(0.50));
+    out += ',';
+    append_uint(out, "p90", percentile(0.90));
+    out += ',';
+    append_uint(out, "p99", percentile(0.99));
+    out += ',';
+    append_uint(out, "p999", percentile(0.999));
+    out += ',';
+    append_uint(out, "max", max);
+    out += '}';
+    return out;
+}
+
+std::string LogStatsSnapshot::to_json() const {
+    std::string out = "{";
+    append_uint(out, "enqueued", enqueued);
+    out += ',';
+    append_uint(out, "written", written);
+    out += ',';
+    append_uint(out, "dropped", dropped);
+    out += ',';
+    append_uint(out, "spilled", spilled);
+    out += ',';
+    append_uint(out, "filtered", filtered);
+    out += ',';
+    append_uint(out, "queue_depth", queue_depth);
+    out += ',';
+    append_uint(out, "queue_high_water", queue_high_water);
+    out += ',';
+    append_uint(out, "queue_capacity", queue_capacity);
+    out += ',';
+    append_uint(out, "queue_full_waits", queue_full_waits);
+    out += ',';
+    append_uint(out, "rotations", rotations);
+    out += ',';
+    append_uint(out, "bytes_written", bytes_written);
+    out += ",\"batch_size\":" + batch_size.to_json();
+    out += ",\"batch_latency_ns\":" + batch_latency_ns.to_json();
+    out += ",\"write_latency_ns\":" + write_latency_ns.to_json();
+    out += ",\"fsync_latency_ns\":" + fsync_latency_ns.to_json();
+    out += '}';
+    return out;
+}
@@ -0,0 +1,114 @@
+#include "LogThread.h"
+
+#include "JsonEscape.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace XZeroThread {
+namespace detail {
+thread_local const Tag* tl_tag = nullptr;
+} // namespace detail
+
+namespace {
+
+// 标签登记表：有意不释放，线程退出后仍在队列中的记录可安全引用
+// 线程号会被内核复用，按 线程号 + 名称 去重后表的规模有界
+struct TagRegistry {
+    std::mutex mutex;
+    std::map<std::pair<std::uint64_t, std::string>, Tag*> tags;
+};
+
+TagRegistry& tag_registry() {
+    static TagRegistry* registry = new TagRegistry;
+    return *registry;
+}
+
+std::uint64_t os_thread_id() {
+#if defined(_WIN32)
+    return static_cast<std::uint64_t>(::GetCurrentThreadId());
+#elif defined(__APPLE__)
+    std::uint64_t id = 0;
+    pthread_threadid_np(nullptr, &id);
+    return id;
+#elif defined(__linux__)
+    return static_cast<std::uint64_t>(::syscall(SYS_gettid));
+#else
+    return static_cast<std::uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+#endif
+}
+
+const Tag& intern(std::uint64_t id, const std::string& name) {
+    TagRegistry& registry = tag_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    Tag*& slot = registry.tags[std::make_pair(id, name)];
+    if (!slot) {
+        Tag* tag = new Tag;
+        tag->id = id;
+        tag->name = name;
+        tag->human = "TID:" + std::to_string(id);
+        tag->json = "\"thread\":\"" + tag->human + "\"";
+        if (!name.empty()) {
+            tag->human += ' ';
+            tag->human += name;
+            tag->json += ",\"thread_name\":\"";
+            XZeroJson::escape_append(tag->json, name);
+            tag->json += '"';
+        }
+        slot = tag;
+    }
+    return *slot;
+}
+
+#if !defined(_WIN32)
+// fork 期间持有登记表锁，避免子进程继承一把被其他线程持有的锁；
+// 子进程只剩调用 fork 的线程，其缓存的线程号已失效，下次记录时重新登记（线程名不保留）
+void lock_before_fork() {
+    tag_registry().mutex.lock();
+}
+
+void unlock_in_parent() {
+    tag_registry().mutex.unlock();
+}
+
+void reset_in_child() {
+    tag_registry().mutex.unlock();
+    detail::tl_tag = nullptr;
+}
+#endif
+
+} // namespace
+
+namespace detail {
+
+const Tag& register_current() {
+#if !defined(_WIN32)
+    static std::once_flag once;
+    std::call_once(once, [] { pthread_atfork(lock_before_fork, unlock_in_parent, reset_in_child); });
+#endif
+    const Tag& tag = intern(os_thread_id(), std::string());
+    tl_tag = &tag;
+    return tag;
+}
+
+} // namespace detail
+
+void set_name(const std::string& name) {
+    const std::uint64_t id = current().id;
+    detail::tl_tag = &intern(id, name);
+}
+
+} // namespace XZeroThread
@@ -0,0 +1,138 @@
+#include "LogTime.h"
+
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+const std::size_t kPrefixLen = 19; // "YYYY-mm-dd HH:MM:SS"
+
+struct SecondCache {
+    std::int64_t second{INT64_MIN}; // 缓存对应的 Unix 秒
+    char prefix[kPrefixLen];        // 秒级前缀（不含结尾 0）
+};
+
+thread_local SecondCache tl_local_cache;
+thread_local SecondCache tl_utc_cache;
+
+inline void write2(char* p, int v) {
+    p[0] = static_cast<char>('0' + v / 10);
+    p[1] = static_cast<char>('0' + v % 10);
+}
+
+inline void write4(char* p, int v) {
+    p[0] = static_cast<char>('0' + (v / 1000) % 10);
+    p[1] = static_cast<char>('0' + (v / 100) % 10);
+    p[2] = static_cast<char>('0' + (v / 10) % 10);
+    p[3] = static_cast<char>('0' + v % 10);
+}
+
+// 刷新秒级前缀；sep 为日期与时间之间的分隔符（' ' 或 'T'）
+void fill_prefix(SecondCache& cache, std::int64_t second, bool utc, char sep) {
+    const std::time_t t = static_cast<std::time_t>(second);
+    std::tm tm{};
+#if defined(_WIN32)
+    if (utc) gmtime_s(&tm, &t); else localtime_s(&tm, &t);
+#else
+    if (utc) gmtime_r(&t, &tm); else localtime_r(&t, &tm);
+#endif
+    char* p = cache.prefix;
+    write4(p, tm.tm_year + 1900);
+    p[4] = '-';
+    write2(p + 5, tm.tm_mon + 1);
+    p[7] = '-';
+    write2(p + 8, tm.tm_mday);
+    p[10] = sep;
+    write2(p + 11, tm.tm_hour);
+    p[13] = ':';
+    write2(p + 14, tm.tm_min);
+    p[16] = ':';
+    write2(p + 17, tm.tm_sec);
+    cache.second = second;
+}
+
+// 写入 ".fff" / ".ffffff" / ".fffffffff"，返回写入长度
+std::size_t write_fraction(char* p, std::int64_t nanos, TimePrecision precision) {
+    int digits = 3;
+    std::int64_t value = nanos / 1000000;
+    if (precision == TimePrecision::Microseconds) {
+        digits = 6;
+        value = nanos / 1000;
+    } else if (precision == TimePrecision::Nanoseconds) {
+        digits = 9;
+        value = nanos;
+    }
+    p[0] = '.';
+    for (int i = digits; i > 0; --i) {
+        p[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return static_cast<std::size_t>(digits) + 1;
+}
+
+std::size_t format_with_cache(SecondCache& cache, const std::chrono::system_clock::time_point& tp,
+                              TimePrecision precision, bool utc, char sep, char* out) {
+    const std::int64_t ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+    std::int64_t second = ns / 1000000000;
+    std::int64_t frac = ns % 1000000000;
+    if (frac < 0) { // 1970 年之前向下取整
+        frac += 1000000000;
+        --second;
+    }
+    if (second != cache.second) {
+        fill_prefix(cache, second, utc, sep);
+    }
+    std::memcpy(out, cache.prefix, kPrefixLen);
+    return kPrefixLen + write_fraction(out + kPrefixLen, frac, precision);
+}
+
+} // namespace
+
+namespace XZeroTime {
+
+std::chrono::system_clock::time_point now(ClockSource source) {
+    switch (source) {
+    case ClockSource::Coarse: {
+#if defined(__linux__) && defined(CLOCK_REALTIME_COARSE)
+        // 粗粒度时钟：无需读 TSC，分辨率约为一个时钟节拍（1~4ms）
+        struct timespec ts;
+        if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0) {
+            return std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+        }
+#endif
+        return std::chrono::system_clock::now();
+    }
+    case ClockSource::Monotonic: {
+        // 以进程首次调用时的墙钟为锚点，之后按单调时钟推进：不受 NTP 回拨影响，时间戳单调不减
+        struct Anchor {
+            std::chrono::system_clock::time_point sys;
+            std::chrono::steady_clock::time_point steady;
+        };
+        static const Anchor anchor = {std::chrono::system_clock::now(),
+                                      std::chrono::steady_clock::now()};
+        return anchor.sys + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                                std::chrono::steady_clock::now() - anchor.steady);
+    }
+    case ClockSource::System:
+    default:
+        return std::chrono::system_clock::now();
+    }
+}
+
+std::size_t format_local(const std::chrono::system_clock::time_point& tp,
+                         TimePrecision precision, char* out) {
+    return format_with_cache(tl_local_cache, tp, precision, false, ' ', out);
+}
+
+std::size_t format_utc(const std::chrono::system_clock::time_point& tp,
+                       TimePrecision precision, char* out) {
+    std::size_t n = format_with_cache(tl_utc_cache, tp, precision, true, 'T', out);
+    out[n++] = 'Z';
+    return n;
+}
+
+} // namespace XZeroTime
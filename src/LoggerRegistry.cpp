@@ -0,0 +1,77 @@
+#include "LoggerRegistry.h"
+
+namespace {
+
+// name 是否等于 prefix 或位于其子树中（"net" 匹配 "net"、"net.http"，不匹配 "network"）
+bool in_subtree(const std::string& name, const std::string& prefix) {
+    if (prefix.empty()) return true;
+    if (name.size() < prefix.size() || name.compare(0, prefix.size(), prefix) != 0) return false;
+    return name.size() == prefix.size() || name[prefix.size()] == '.';
+}
+
+// 最长前缀匹配；没有匹配项时返回 end()
+template <typename Map>
+typename Map::const_iterator longest_match(const Map& map, const std::string& name) {
+    auto best = map.end();
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        if (in_subtree(name, it->first) &&
+            (best == map.end() || it->first.size() > best->first.size())) {
+            best = it;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+LoggerRegistry& LoggerRegistry::instance() {
+    // 函数内静态对象：进程退出时析构，日志器与后端依次写出剩余记录
+    static LoggerRegistry registry;
+    return registry;
+}
+
+void LoggerRegistry::configure(const std::string& name, const LoggerConfig& cfg) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    configs_[name] = cfg;
+}
+
+Logger* LoggerRegistry::get(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = loggers_.find(name);
+    if (it != loggers_.end()) {
+        return it->second.get();
+    }
+
+    auto cfg_it = longest_match(configs_, name);
+    const LoggerConfig cfg = cfg_it != configs_.end() ? cfg_it->second : LoggerConfig();
+    std::unique_ptr<FileLogger> logger(new FileLogger(LogBackend::acquire(cfg), cfg, name));
+    // 显式设置过的等级覆盖配置中的 onlyLevels / disableLevels
+    auto level_it = longest_match(levels_, name);
+    if (level_it != levels_.end()) {
+        logger->set_level_mask(level_it->second);
+    }
+    FileLogger* handle = logger.get();
+    loggers_[name] = std::move(logger);
+    return handle;
+}
+
+void LoggerRegistry::set_level(const std::string& name, LoggerLevel level) {
+    set_level_mask(name, Logger::mask_at_least(level));
+}
+
+void LoggerRegistry::set_level_mask(const std::string& name, unsigned mask) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    levels_[name] = mask;
+    for (auto& kv : loggers_) {
+        if (in_subtree(kv.first, name)) {
+            kv.second->set_level_mask(longest_match(levels_, kv.first)->second);
+        }
+    }
+}
+
+void LoggerRegistry::set_format_flag(LogFormatter::FormatFlag flag, bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& kv : loggers_) {
+        kv.second->set_format_flag(flag, enabled);
+    }
+}
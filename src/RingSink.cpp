@@ -0,0 +1,44 @@
+#include "RingSink.h"
+
+RingSink::RingSink(std::size_t capacity, LogFormat format)
+    // Binary 没有文本形式，退回 HumanFriendly
+    : LogSink(format == LogFormat::Binary ? LogFormat::HumanFriendly : format),
+      lines_(capacity > 0 ? capacity : 1) {}
+
+void RingSink::write(const LogEntry& entry) {
+    const std::string& line = entry.text(format());
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 复用槽位已有的容量
+    lines_[next_].assign(line);
+    next_ = (next_ + 1) % lines_.size();
+    ++total_;
+}
+
+std::vector<std::string> RingSink::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::size_t cap = lines_.size();
+    const std::size_t count = total_ < cap ? total_ : cap;
+    std::vector<std::string> out;
+    out.reserve(count);
+    const std::size_t start = total_ < cap ? 0 : next_;
+    for (std::size_t i = 0; i < count; ++i) {
+        out.push_back(lines_[(start + i) % cap]);
+    }
+    return out;
+}
+
+std::size_t RingSink::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_ < lines_.size() ? total_ : lines_.size();
+}
+
+std::size_t RingSink::total() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_;
+}
+
+void RingSink::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    next_ = 0;
+    total_ = 0;
+}
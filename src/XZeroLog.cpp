@@ -1,8 +1,13 @@
 #include "XZeroLog.h"
 
 #include "FileLogger.h"
+#include "LogThread.h"
 
 std::unique_ptr<Logger> XZeroLog::InitLogger(const LoggerConfig& config) {
     // 直接传入用户配置，构造线程安全的 FileLogger
     return std::unique_ptr<Logger>(new FileLogger(config));
 }
+
+void XZeroLog::set_thread_name(const std::string& name) {
+    XZeroThread::set_name(name);
+}
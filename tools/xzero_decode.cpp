@@ -0,0 +1,114 @@
+// xzero_decode：将 LogFormat::Binary 生成的日志还原为 HumanFriendly 或 Json 文本
+// 压缩备份（.xzlz / .gz）先自动解压；解压后为文本日志时原样输出
+//
+// 用法：xzero_decode [--json] [--no-time] [--no-platform] [--no-source]
+//                    [--no-mdc] [--no-error-code] <file>...
+#include "BinaryLog.h"
+#include "LogCompress.h"
+#include "LogFormatter.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+void print_usage(const char* prog) {
+    std::cerr << "用法: " << prog
+              << " [--json] [--no-time] [--no-platform] [--no-source]"
+                 " [--no-mdc] [--no-error-code] <file>..."
+              << std::endl;
+}
+
+bool read_file(const std::string& path, std::string& out) {
+    std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    LoggerConfig cfg;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--json") == 0) {
+            cfg.logFormat = LogFormat::Json;
+        } else if (std::strcmp(arg, "--no-time") == 0) {
+            cfg.writeTime = false;
+        } else if (std::strcmp(arg, "--no-platform") == 0) {
+            cfg.includePlatform = false;
+        } else if (std::strcmp(arg, "--no-source") == 0) {
+            cfg.includeSource = false;
+        } else if (std::strcmp(arg, "--no-mdc") == 0) {
+            cfg.includeMdc = false;
+        } else if (std::strcmp(arg, "--no-error-code") == 0) {
+            cfg.useErrorCode = false;
+        } else if (std::strcmp(arg, "-h") == 0 || std::strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg[0] == '-') {
+            std::cerr << "未知参数: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 2;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    int status = 0;
+    for (const auto& path : files) {
+        std::string data;
+        if (!read_file(path, data)) {
+            std::cerr << "无法读取文件: " << path << std::endl;
+            status = 1;
+            continue;
+        }
+        if (XZeroCompress::looks_compressed(data)) {
+            std::string raw;
+            if (!XZeroCompress::decompress(data, raw)) {
+                std::cerr << "解压失败: " << path << std::endl;
+                status = 1;
+                continue;
+            }
+            data.swap(raw);
+            if (!XZeroBinary::Decoder::looks_binary(data)) {
+                std::cout << data;
+                continue;
+            }
+        }
+        if (!XZeroBinary::Decoder::looks_binary(data)) {
+            std::cerr << "不是二进制日志文件: " << path << std::endl;
+            status = 1;
+            continue;
+        }
+
+        // 平台信息来自文件头，会话切换时才重建格式化器
+        std::string platform;
+        std::unique_ptr<LogFormatter> formatter;
+        XZeroBinary::Decoder decoder;
+        const bool ok = decoder.decode(data, [&](const LogRecord& rec, const std::string& plat) {
+            if (!formatter || plat != platform) {
+                platform = plat;
+                formatter.reset(new LogFormatter(cfg, platform));
+            }
+            std::cout << formatter->format(rec) << '\n';
+        });
+        if (!ok) {
+            std::cerr << "文件损坏或被截断: " << path << std::endl;
+            status = 1;
+        }
+    }
+    std::cout.flush();
+    return status;
+}